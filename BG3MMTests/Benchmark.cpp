@@ -0,0 +1,102 @@
+#include "pch.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <crtdbg.h>
+
+// Benchmark::PeakMemory installs a debug CRT allocation hook only for as long as a scope is alive, so the
+// rest of the test module allocates exactly as it would without it. The hook sees operator new and malloc
+// alike, from every thread. Release CRTs have no allocation hooks, and nothing is measured there.
+
+namespace { // anonymous namespace
+
+std::atomic<int64_t> live{0};
+std::atomic<int64_t> peakLive{0};
+std::atomic<size_t> count{0};
+
+#ifdef _DEBUG
+
+_CRT_ALLOC_HOOK previousHook = nullptr;
+
+void track(int64_t bytes)
+{
+    auto current = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+    auto peak = peakLive.load(std::memory_order_relaxed);
+    while (current > peak && !peakLive.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+int __cdecl allocationHook(int allocType, void* userData, size_t size, int blockType, long /*requestNumber*/,
+                           const unsigned char* /*filename*/, int /*lineNumber*/)
+{
+    // The CRT's own blocks must be ignored, or the hook would recurse through them
+    if (blockType == _CRT_BLOCK) {
+        return TRUE;
+    }
+
+    switch (allocType) {
+    case _HOOK_ALLOC:
+        count.fetch_add(1, std::memory_order_relaxed);
+        track(static_cast<int64_t>(size));
+        break;
+    case _HOOK_REALLOC:
+        count.fetch_add(1, std::memory_order_relaxed);
+        track(static_cast<int64_t>(size) - (userData ? static_cast<int64_t>(_msize_dbg(userData, blockType)) : 0));
+        break;
+    case _HOOK_FREE:
+        if (userData) {
+            track(-static_cast<int64_t>(_msize_dbg(userData, blockType)));
+        }
+        break;
+    default:
+        break;
+    }
+
+    return TRUE;
+}
+
+#endif // _DEBUG
+
+} // anonymous namespace
+
+namespace Benchmark { // Benchmark namespace
+
+PeakMemory::PeakMemory()
+{
+    live = 0;
+    peakLive = 0;
+    count = 0;
+
+#ifdef _DEBUG
+    previousHook = _CrtSetAllocHook(allocationHook);
+#endif
+}
+
+PeakMemory::~PeakMemory()
+{
+#ifdef _DEBUG
+    _CrtSetAllocHook(previousHook);
+#endif
+}
+
+size_t PeakMemory::peak() const
+{
+    return static_cast<size_t>(std::max<int64_t>(0, peakLive.load()));
+}
+
+size_t PeakMemory::allocations() const
+{
+    return count.load();
+}
+
+bool PeakMemory::available()
+{
+#ifdef _DEBUG
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace Benchmark
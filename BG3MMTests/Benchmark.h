@@ -0,0 +1,85 @@
+#pragma once
+
+#include <chrono>
+#include <format>
+#include <string>
+
+// Minimal timing harness for the micro-benchmarks.
+// Results go to the test output window; they are informational and never fail a test.
+namespace Benchmark { // Benchmark namespace
+
+struct Result
+{
+    size_t iterations;
+    double totalMs;
+
+    double nsPerIteration() const
+    {
+        return iterations == 0 ? 0.0 : totalMs * 1'000'000.0 / static_cast<double>(iterations);
+    }
+};
+
+template <typename F>
+Result run(size_t iterations, F&& body)
+{
+    body(); // warm up caches and any lazily created state
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        body();
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    return {iterations, elapsed.count()};
+}
+
+// Peak of the bytes allocated on the CRT heap, by any thread, while the scope is alive, relative to its
+// start, and the number of allocations made. Only debug builds can measure; see available().
+// One scope may be active at a time.
+class PeakMemory
+{
+public:
+    PeakMemory();
+    ~PeakMemory();
+
+    PeakMemory(const PeakMemory&) = delete;
+    PeakMemory& operator=(const PeakMemory&) = delete;
+
+    size_t peak() const;
+    size_t allocations() const;
+
+    // False where the CRT has no allocation hooks (release builds); peak() and allocations() are then zero
+    static bool available();
+};
+
+// Value of an environment variable naming benchmark inputs or outputs; empty when it is not set
+inline std::string environment(const char* name)
+{
+    char* value = nullptr;
+    size_t length = 0;
+    if (_dupenv_s(&value, &length, name) != 0 || value == nullptr) {
+        return {};
+    }
+
+    std::string result(value);
+    free(value);
+
+    return result;
+}
+
+// Benchmarks are opt-in: they run on the inputs named by their BG3MM_BENCH_* variable, or on synthetic
+// stand-ins when BG3MM_BENCH_SYNTHETIC is set, and are skipped otherwise
+inline bool synthetic()
+{
+    return !environment("BG3MM_BENCH_SYNTHETIC").empty();
+}
+
+inline std::string format(const char* name, const Result& result)
+{
+    return std::format("{:<40} {:>10} iterations {:>10.1f} ms {:>12.0f} ns/iteration\n",
+                       name, result.iterations, result.totalMs, result.nsPerIteration());
+}
+
+} // namespace Benchmark
@@ -0,0 +1,76 @@
+#include "pch.h"
+
+#include <CppUnitTest.h>
+#include <cstdint>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "CRC32.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace { // anonymous namespace
+
+uint32_t crc(std::string_view s)
+{
+    return CRC32::compute(reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+// Bit-at-a-time reference for the reflected 0xEDB88320 polynomial
+uint32_t referenceCRC(const uint8_t* data, size_t length)
+{
+    uint32_t value = 0xFFFFFFFF;
+
+    for (size_t i = 0; i < length; ++i) {
+        value ^= data[i];
+        for (auto bit = 0; bit < 8; ++bit) {
+            value = value & 1 ? value >> 1 ^ 0xEDB88320 : value >> 1;
+        }
+    }
+
+    return value ^ 0xFFFFFFFF;
+}
+
+} // anonymous namespace
+
+TEST_CLASS(CRC32Tests)
+{
+public:
+    TEST_METHOD(TestKnownValues)
+    {
+        Assert::AreEqual(0x00000000u, crc(""));
+        Assert::AreEqual(0xE8B7BE43u, crc("a"));
+        Assert::AreEqual(0xCBF43926u, crc("123456789"));
+        Assert::AreEqual(0x414FA339u, crc("The quick brown fox jumps over the lazy dog"));
+    }
+
+    TEST_METHOD(TestMatchesReference)
+    {
+        std::mt19937 rng(0xC3C);
+        std::vector<uint8_t> data(4096);
+        for (auto& b : data) {
+            b = static_cast<uint8_t>(rng());
+        }
+
+        // Every length around the eight-byte stride, from unaligned starting points
+        for (size_t offset = 0; offset < 8; ++offset) {
+            for (size_t length = 0; length < 80; ++length) {
+                Assert::AreEqual(referenceCRC(&data[offset], length), CRC32::compute(&data[offset], length));
+            }
+        }
+
+        Assert::AreEqual(referenceCRC(data.data(), data.size()), CRC32::compute(data.data(), data.size()));
+    }
+
+    TEST_METHOD(TestUpdate)
+    {
+        std::string_view text = "The quick brown fox jumps over the lazy dog";
+        auto data = reinterpret_cast<const uint8_t*>(text.data());
+
+        for (size_t split = 0; split <= text.size(); ++split) {
+            auto value = CRC32::update(CRC32::compute(data, split), data + split, text.size() - split);
+            Assert::AreEqual(0x414FA339u, value);
+        }
+    }
+};
@@ -0,0 +1,424 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "Benchmark.h"
+#include "Bitknit2Decompressor.h"
+#include "GR2Reader.h"
+#include "LZ4Compressor.h"
+#include "PAKReader.h"
+#include "ZLibCompressor.h"
+#include "ZSTDCompressor.h"
+
+#include <CppUnitTest.h>
+#include <lz4frame.h>
+
+#include <map>
+#include <unordered_map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+constexpr size_t CORPUS_BUDGET = 32 * 1024 * 1024; // largest corpus taken from a package
+constexpr size_t TARGET_BYTES = 64 * 1024 * 1024; // data pushed through a codec per measurement
+constexpr size_t MAX_ITERATIONS = 50;
+
+struct Corpus
+{
+    std::string name;
+    std::vector<ByteBuffer> files;
+    size_t bytes{0};
+
+    void add(const uint8_t* data, size_t size)
+    {
+        ByteBuffer file{std::make_unique<uint8_t[]>(size), size};
+        memcpy(file.first.get(), data, size);
+        files.emplace_back(std::move(file));
+        bytes += size;
+    }
+};
+
+// BitKnit2-compressed GR2 sections; there is no encoder, so they only come from real models
+struct Bitknit2Section
+{
+    ByteBuffer compressed;
+    uint32_t decompressedSize;
+};
+
+// Compresses and decompresses one file at a time, as PAK entries are
+struct Codec
+{
+    std::string name;
+    std::string level;
+    std::function<ByteBuffer(const ByteBuffer& input)> compress;
+    std::function<size_t(const ByteBuffer& compressed, std::span<uint8_t> output)> decompress;
+};
+
+struct Row
+{
+    std::string corpus;
+    std::string codec;
+    std::string level;
+    size_t files{0};
+    size_t inputBytes{0};
+    size_t compressedBytes{0};
+    double compressMBs{0.0};
+    double decompressMBs{0.0};
+    size_t peakCompress{0};
+    size_t peakDecompress{0};
+};
+
+const char* levelName(LSCompressionLevel level)
+{
+    switch (level) {
+    case LSCompressionLevel::FAST:
+        return "fast";
+    case LSCompressionLevel::MAX:
+        return "max";
+    default:
+        return "default";
+    }
+}
+
+std::string corpusFor(const std::string& name)
+{
+    auto ext = fs::path(name).extension().string();
+    std::ranges::transform(ext, ext.begin(), tolower);
+
+    static const std::unordered_map<std::string, std::string> corpora = {
+        {".lsx", "text"}, {".lsj", "text"}, {".xml", "text"}, {".txt", "text"}, {".khn", "text"},
+        {".lsf", "binary"}, {".lsfx", "binary"}, {".loca", "binary"}, {".lsbc", "binary"},
+        {".dds", "textures"},
+        {".gr2", "models"}
+    };
+
+    auto it = corpora.find(ext);
+
+    return it != corpora.end() ? it->second : "other";
+}
+
+void addSections(const PackagedFileData& contents, std::vector<Bitknit2Section>& sections)
+{
+    if (contents.size() < sizeof(GR2Header)) {
+        return;
+    }
+
+    GR2Header header;
+    memcpy(&header, contents.data(), sizeof(GR2Header));
+
+    auto* headers = contents.data() + sizeof(GR2Header);
+    if (sizeof(GR2Header) + header.numSections * sizeof(GR2SectionHeader) > contents.size()) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < header.numSections; ++i) {
+        GR2SectionHeader section;
+        memcpy(&section, headers + i * sizeof(GR2SectionHeader), sizeof(GR2SectionHeader));
+
+        if (section.compressType != COMPRESSION_BITKNIT2 || section.decompressedLen == 0
+            || static_cast<uint64_t>(section.dataOffset) + section.compressedLen > contents.size()) {
+            continue;
+        }
+
+        ByteBuffer compressed{std::make_unique<uint8_t[]>(section.compressedLen), section.compressedLen};
+        memcpy(compressed.first.get(), contents.data() + section.dataOffset, section.compressedLen);
+        sections.push_back({std::move(compressed), section.decompressedLen});
+    }
+}
+
+// Files of a real package by kind, up to CORPUS_BUDGET each
+std::vector<Corpus> packageCorpora(const std::string& pakPath, std::vector<Bitknit2Section>& sections)
+{
+    PAKReader reader;
+    reader.read(pakPath.c_str(), true);
+
+    std::map<std::string, Corpus> corpora;
+
+    reader.scanFiles(nullptr, [&](size_t, const PackagedFileInfo& file, const PackagedFileData& contents) {
+        auto& corpus = corpora[corpusFor(file.name)];
+        if (contents.size() == 0 || corpus.bytes + contents.size() > CORPUS_BUDGET) {
+            return true;
+        }
+
+        corpus.add(contents.data(), contents.size());
+
+        if (corpusFor(file.name) == "models") {
+            addSections(contents, sections);
+        }
+
+        return true;
+    });
+
+    std::vector<Corpus> result;
+    for (auto& [name, corpus] : corpora) {
+        corpus.name = name;
+        result.emplace_back(std::move(corpus));
+    }
+
+    return result;
+}
+
+// Stand-ins shaped like the main kinds of package content
+std::vector<Corpus> syntheticCorpora()
+{
+    std::mt19937 rng(0xC0DEC);
+    std::vector<Corpus> corpora(4);
+
+    corpora[0].name = "synthetic-text";
+    for (auto i = 0; i < 400; ++i) {
+        std::string xml = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<save>\n  <region id=\"Templates\">\n";
+        for (auto j = 0; j < 8 + static_cast<int>(rng() % 24); ++j) {
+            xml += std::format("    <node id=\"GameObjects\">\n"
+                               "      <attribute id=\"MapKey\" type=\"FixedString\" value=\"{:08x}-{:04x}\"/>\n"
+                               "      <attribute id=\"Name\" type=\"LSString\" value=\"ITEM_{}_{}\"/>\n"
+                               "      <attribute id=\"Weight\" type=\"float\" value=\"{}\"/>\n"
+                               "    </node>\n", rng(), rng() & 0xFFFF, i, j, rng() % 100);
+        }
+
+        xml += "  </region>\n</save>\n";
+        corpora[0].add(reinterpret_cast<const uint8_t*>(xml.data()), xml.size());
+    }
+
+    corpora[1].name = "synthetic-binary";
+    for (auto i = 0; i < 200; ++i) {
+        // Fixed-size records of small integers and indices, like LSF node and attribute tables
+        std::vector<uint32_t> records(1024 + rng() % 8192);
+        for (size_t j = 0; j < records.size(); ++j) {
+            records[j] = j % 4 == 0 ? static_cast<uint32_t>(j / 4) : rng() % (j % 4 == 1 ? 32 : 4096);
+        }
+
+        corpora[1].add(reinterpret_cast<const uint8_t*>(records.data()), records.size() * sizeof(uint32_t));
+    }
+
+    corpora[2].name = "synthetic-texture";
+    for (auto i = 0; i < 16; ++i) {
+        // Smooth gradients with sensor-like noise compress a little, as uncompressed texture data does
+        std::vector<uint8_t> pixels(512 * 512 * 4);
+        for (size_t j = 0; j < pixels.size(); ++j) {
+            pixels[j] = static_cast<uint8_t>((j / 4 % 512 + j / 2048) / 4 + rng() % 8);
+        }
+
+        corpora[2].add(pixels.data(), pixels.size());
+    }
+
+    corpora[3].name = "synthetic-random";
+    for (auto i = 0; i < 16; ++i) {
+        // Already-compressed payloads such as audio banks
+        std::vector<uint8_t> noise(256 * 1024);
+        std::ranges::generate(noise, [&] { return static_cast<uint8_t>(rng()); });
+        corpora[3].add(noise.data(), noise.size());
+    }
+
+    return corpora;
+}
+
+ByteBuffer toBuffer(Stream&& stream)
+{
+    return stream.detach();
+}
+
+std::vector<Codec> codecs(ZLibCompressor& zlib, LZ4Compressor& lz4, ZSTDCompressor& zstd)
+{
+    std::vector<Codec> result;
+
+    result.push_back({
+        "lz4", "default",
+        [&](const ByteBuffer& input) {
+            return toBuffer(lz4.compress(input.first.get(), input.second, LSCompressionLevel::DEFAULT));
+        },
+        [&](const ByteBuffer& compressed, std::span<uint8_t> output) {
+            return lz4.decompress(compressed.first.get(), compressed.second, output);
+        }
+    });
+
+    result.push_back({
+        "lz4-frame", "default",
+        [](const ByteBuffer& input) {
+            auto bound = LZ4F_compressFrameBound(input.second, nullptr);
+            ByteBuffer output{std::make_unique<uint8_t[]>(bound), 0};
+            output.second = LZ4F_compressFrame(output.first.get(), bound, input.first.get(), input.second, nullptr);
+            Assert::IsFalse(LZ4F_isError(output.second));
+            return output;
+        },
+        [&](const ByteBuffer& compressed, std::span<uint8_t> output) {
+            return lz4.decompress(compressed.first.get(), compressed.second, output, true);
+        }
+    });
+
+    for (auto level : {LSCompressionLevel::FAST, LSCompressionLevel::DEFAULT, LSCompressionLevel::MAX}) {
+        for (auto* compressor : {static_cast<ICompressor*>(&zlib), static_cast<ICompressor*>(&zstd)}) {
+            result.push_back({
+                compressor == &zlib ? "zlib" : "zstd", levelName(level),
+                [compressor, level](const ByteBuffer& input) {
+                    return toBuffer(compressor->compress(input.first.get(), input.second, level));
+                },
+                [compressor](const ByteBuffer& compressed, std::span<uint8_t> output) {
+                    return compressor->decompress(compressed.first.get(), compressed.second, output);
+                }
+            });
+        }
+    }
+
+    return result;
+}
+
+double megabytesPerSecond(size_t bytes, const Benchmark::Result& result)
+{
+    return static_cast<double>(bytes) * static_cast<double>(result.iterations) / (1024.0 * 1024.0)
+        / (result.totalMs / 1000.0);
+}
+
+size_t iterationsFor(size_t bytes)
+{
+    return std::clamp<size_t>(TARGET_BYTES / std::max<size_t>(bytes, 1), 1, MAX_ITERATIONS);
+}
+
+Row measure(const Corpus& corpus, const Codec& codec)
+{
+    Row row{corpus.name, codec.name, codec.level, corpus.files.size(), corpus.bytes};
+
+    std::vector<ByteBuffer> compressed;
+    compressed.reserve(corpus.files.size());
+
+    for (const auto& file : corpus.files) {
+        Benchmark::PeakMemory memory;
+        auto output = codec.compress(file);
+        row.peakCompress = std::max(row.peakCompress, memory.peak());
+        row.compressedBytes += output.second;
+        compressed.emplace_back(std::move(output));
+    }
+
+    auto iterations = iterationsFor(corpus.bytes);
+
+    auto compressResult = Benchmark::run(iterations, [&] {
+        for (const auto& file : corpus.files) {
+            codec.compress(file);
+        }
+    });
+
+    size_t largest = 0;
+    for (const auto& file : corpus.files) {
+        largest = std::max(largest, file.second);
+    }
+
+    std::vector<uint8_t> output(largest);
+
+    for (size_t i = 0; i < compressed.size(); ++i) {
+        Benchmark::PeakMemory memory;
+        auto size = codec.decompress(compressed[i], {output.data(), corpus.files[i].second});
+        row.peakDecompress = std::max(row.peakDecompress, memory.peak());
+
+        Assert::AreEqual(corpus.files[i].second, size);
+        Assert::IsTrue(memcmp(output.data(), corpus.files[i].first.get(), size) == 0);
+    }
+
+    auto decompressResult = Benchmark::run(iterations, [&] {
+        for (size_t i = 0; i < compressed.size(); ++i) {
+            codec.decompress(compressed[i], {output.data(), corpus.files[i].second});
+        }
+    });
+
+    row.compressMBs = megabytesPerSecond(corpus.bytes, compressResult);
+    row.decompressMBs = megabytesPerSecond(corpus.bytes, decompressResult);
+
+    return row;
+}
+
+Row measureBitknit2(const std::vector<Bitknit2Section>& sections)
+{
+    Row row{"models", "bitknit2", "n/a", sections.size()};
+
+    uint32_t largest = 0;
+    for (const auto& section : sections) {
+        row.inputBytes += section.decompressedSize;
+        row.compressedBytes += section.compressed.second;
+        largest = std::max(largest, section.decompressedSize);
+    }
+
+    std::vector<uint8_t> output(largest);
+
+    auto decompressAll = [&] {
+        for (const auto& section : sections) {
+            Bitknit2Decompressor decompressor;
+            Assert::IsTrue(decompressor.Decompress(static_cast<uint32_t>(section.compressed.second),
+                                                   section.compressed.first.get(), section.decompressedSize,
+                                                   output.data()));
+        }
+    };
+
+    {
+        Benchmark::PeakMemory memory;
+        decompressAll();
+        row.peakDecompress = memory.peak();
+    }
+
+    auto result = Benchmark::run(iterationsFor(row.inputBytes), decompressAll);
+    row.decompressMBs = megabytesPerSecond(row.inputBytes, result);
+
+    return row;
+}
+
+std::string csvHeader()
+{
+    return "corpus,codec,level,files,input_bytes,compressed_bytes,ratio,compress_mb_s,decompress_mb_s,"
+        "peak_compress_bytes,peak_decompress_bytes\n";
+}
+
+std::string csvLine(const Row& row)
+{
+    auto ratio = row.compressedBytes == 0
+                     ? 0.0
+                     : static_cast<double>(row.inputBytes) / static_cast<double>(row.compressedBytes);
+
+    return std::format("{},{},{},{},{},{},{:.3f},{:.1f},{:.1f},{},{}\n", row.corpus, row.codec, row.level, row.files,
+                       row.inputBytes, row.compressedBytes, ratio, row.compressMBs, row.decompressMBs,
+                       row.peakCompress, row.peakDecompress);
+}
+
+} // anonymous namespace
+
+// Throughput, ratio and peak memory of every codec over package-like content.
+// BG3MM_BENCH_PAK selects a real package to draw the corpora from; BG3MM_BENCH_SYNTHETIC uses stand-ins.
+// Results are logged as CSV, and also written to BG3MM_BENCH_OUTPUT when it is set.
+TEST_CLASS(CodecBenchmarks)
+{
+public:
+    TEST_METHOD(BenchmarkCodecs)
+    {
+        std::vector<Bitknit2Section> sections;
+
+        auto pakPath = Benchmark::environment("BG3MM_BENCH_PAK");
+        if (pakPath.empty() && !Benchmark::synthetic()) {
+            Logger::WriteMessage("BG3MM_BENCH_PAK and BG3MM_BENCH_SYNTHETIC are not set; skipping.\n");
+            return;
+        }
+
+        auto corpora = pakPath.empty() ? syntheticCorpora() : packageCorpora(pakPath, sections);
+
+        ZLibCompressor zlib;
+        LZ4Compressor lz4;
+        ZSTDCompressor zstd;
+
+        std::string csv = csvHeader();
+
+        for (const auto& corpus : corpora) {
+            for (const auto& codec : codecs(zlib, lz4, zstd)) {
+                csv += csvLine(measure(corpus, codec));
+            }
+        }
+
+        if (!sections.empty()) {
+            csv += csvLine(measureBitknit2(sections));
+        }
+
+        auto outputPath = Benchmark::environment("BG3MM_BENCH_OUTPUT");
+        if (!outputPath.empty()) {
+            std::ofstream ofs(outputPath, std::ios::binary);
+            ofs << csv;
+
+            Logger::WriteMessage(std::format("Results written to {}\n", outputPath).c_str());
+        }
+
+        Logger::WriteMessage(csv.c_str());
+    }
+};
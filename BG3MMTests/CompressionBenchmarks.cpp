@@ -0,0 +1,213 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "Benchmark.h"
+#include "Compress.h"
+#include "LZ4Compressor.h"
+#include "PAKReader.h"
+#include "PAKWriter.h"
+#include "ZSTDCompressor.h"
+
+#include <CppUnitTest.h>
+#include <lz4frame.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+constexpr size_t SMALL_FILE_SIZE = 4 * 1024;
+constexpr size_t ITERATIONS = 20000;
+
+ByteBuffer makeInput(size_t size)
+{
+    ByteBuffer buffer{std::make_unique<uint8_t[]>(size), size};
+
+    // Repetitive text with some variation, roughly like the LSX/LSJ files in a package
+    for (size_t i = 0; i < size; ++i) {
+        buffer.first[i] = static_cast<uint8_t>("<attribute id=\"Name\" />"[i % 24] + (i / 512) % 3);
+    }
+
+    return buffer;
+}
+
+ByteBuffer compressFrame(const ByteBuffer& input)
+{
+    auto bound = LZ4F_compressFrameBound(input.second, nullptr);
+    ByteBuffer output{std::make_unique<uint8_t[]>(bound), bound};
+
+    auto size = LZ4F_compressFrame(output.first.get(), bound, input.first.get(), input.second, nullptr);
+    Assert::IsFalse(LZ4F_isError(size));
+
+    output.second = size;
+
+    return output;
+}
+
+// What every call paid before contexts were reused
+void decompressFrameWithNewContext(const ByteBuffer& compressed, size_t uncompressedSize)
+{
+    auto output = std::make_unique<uint8_t[]>(uncompressedSize);
+
+    LZ4F_dctx* dctx;
+    LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION);
+
+    auto dstSize = uncompressedSize;
+    auto srcSize = compressed.second;
+    LZ4F_decompress(dctx, output.get(), &dstSize, compressed.first.get(), &srcSize, nullptr);
+
+    LZ4F_freeDecompressionContext(dctx);
+}
+
+template <typename TCompressor>
+void compareDecompress(const char* name, CompressionMethod method)
+{
+    auto input = makeInput(SMALL_FILE_SIZE);
+    auto compressed = Compression::compress(method, input.first.get(), input.second, LSCompressionLevel::DEFAULT);
+
+    auto perCall = Benchmark::run(ITERATIONS, [&] {
+        TCompressor compressor;
+        compressor.decompress(compressed.data(), compressed.size(), SMALL_FILE_SIZE);
+    });
+
+    auto pooled = Benchmark::run(ITERATIONS, [&] {
+        Compression::decompress(method, compressed.data(), compressed.size(), SMALL_FILE_SIZE);
+    });
+
+    Logger::WriteMessage(Benchmark::format(std::format("{} decompress, new compressor", name).c_str(), perCall).c_str());
+    Logger::WriteMessage(Benchmark::format(std::format("{} decompress, pooled", name).c_str(), pooled).c_str());
+
+    auto output = Compression::decompress(method, compressed.data(), compressed.size(), SMALL_FILE_SIZE);
+    Assert::AreEqual(0, memcmp(output.data(), input.first.get(), SMALL_FILE_SIZE));
+}
+
+template <typename TCompressor>
+void compareCompress(const char* name, CompressionMethod method)
+{
+    auto input = makeInput(SMALL_FILE_SIZE);
+
+    auto perCall = Benchmark::run(ITERATIONS, [&] {
+        TCompressor compressor;
+        compressor.compress(input.first.get(), input.second, LSCompressionLevel::DEFAULT);
+    });
+
+    auto pooled = Benchmark::run(ITERATIONS, [&] {
+        Compression::compress(method, input.first.get(), input.second, LSCompressionLevel::DEFAULT);
+    });
+
+    Logger::WriteMessage(Benchmark::format(std::format("{} compress, new compressor", name).c_str(), perCall).c_str());
+    Logger::WriteMessage(Benchmark::format(std::format("{} compress, pooled", name).c_str(), pooled).c_str());
+}
+
+// Every regular file beneath root, named relative to it as a package would store it
+std::vector<PackageBuildInputFile> modFiles(const fs::path& root)
+{
+    std::vector<PackageBuildInputFile> files;
+
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file()) {
+            auto name = fs::relative(entry.path(), root).generic_string();
+            files.push_back({entry.path().string(), name});
+        }
+    }
+
+    return files;
+}
+
+void benchmarkPackage(const char* name, const fs::path& pakPath, PackageBuildData build)
+{
+    PAKWriter writer(std::move(build), pakPath.string().c_str());
+    writer.write();
+    writer.close();
+
+    PAKReader reader;
+    reader.read(pakPath.string().c_str(), true);
+
+    size_t bytes = 0;
+    auto result = Benchmark::run(5, [&] {
+        bytes = 0;
+        reader.scanFiles(nullptr, [&](size_t, const PackagedFileInfo&, const PackagedFileData& contents) {
+            bytes += contents.size();
+            return true;
+        });
+    });
+
+    auto mbPerSecond = static_cast<double>(bytes) * result.iterations / (result.totalMs / 1000.0) / (1024 * 1024);
+
+    Logger::WriteMessage(std::format("{:<20} {:>12} bytes on disk {:>10.1f} MB/s decoded\n", name,
+                                     fs::file_size(pakPath), mbPerSecond).c_str());
+
+    reader.close();
+}
+
+} // anonymous namespace
+
+// Per-call overhead of the compression API on small, package-sized files.
+TEST_CLASS(CompressionBenchmarks)
+{
+public:
+    TEST_METHOD(BenchmarkZSTDContexts)
+    {
+        compareDecompress<ZSTDCompressor>("ZSTD", CompressionMethod::ZSTD);
+        compareCompress<ZSTDCompressor>("ZSTD", CompressionMethod::ZSTD);
+    }
+
+    TEST_METHOD(BenchmarkLZ4Contexts)
+    {
+        compareDecompress<LZ4Compressor>("LZ4", CompressionMethod::LZ4);
+        compareCompress<LZ4Compressor>("LZ4", CompressionMethod::LZ4);
+    }
+
+    TEST_METHOD(BenchmarkLZ4FrameContexts)
+    {
+        auto input = makeInput(SMALL_FILE_SIZE);
+        auto compressed = compressFrame(input);
+
+        auto perCall = Benchmark::run(ITERATIONS, [&] {
+            decompressFrameWithNewContext(compressed, SMALL_FILE_SIZE);
+        });
+
+        auto pooled = Benchmark::run(ITERATIONS, [&] {
+            Compression::decompress(CompressionMethod::LZ4, compressed.first.get(), compressed.second,
+                                    SMALL_FILE_SIZE, true);
+        });
+
+        Logger::WriteMessage(Benchmark::format("LZ4 frame decompress, new context", perCall).c_str());
+        Logger::WriteMessage(Benchmark::format("LZ4 frame decompress, pooled", pooled).c_str());
+
+        // A reused context must come back clean after each frame
+        for (auto i = 0; i < 2; ++i) {
+            auto output = Compression::decompress(CompressionMethod::LZ4, compressed.first.get(), compressed.second,
+                                                  SMALL_FILE_SIZE, true);
+            Assert::AreEqual(0, memcmp(output.data(), input.first.get(), SMALL_FILE_SIZE));
+        }
+    }
+
+    // Set BG3MM_BENCH_MOD_DIR to an unpacked mod to compare archive size and decode speed
+    TEST_METHOD(BenchmarkDictionaryOnModTree)
+    {
+        auto modDir = Benchmark::environment("BG3MM_BENCH_MOD_DIR");
+        if (modDir.empty()) {
+            Logger::WriteMessage("BG3MM_BENCH_MOD_DIR is not set; skipping.\n");
+            return;
+        }
+
+        fs::path root(modDir);
+
+        PackageBuildData build;
+        build.files = modFiles(root);
+
+        auto output = fs::temp_directory_path() / "bg3mm_dictionary_bench";
+        fs::create_directories(output);
+
+        build.compression = CompressionMethod::LZ4;
+        benchmarkPackage("LZ4", output / "lz4.pak", build);
+
+        build.compression = CompressionMethod::ZSTD;
+        benchmarkPackage("ZSTD", output / "zstd.pak", build);
+
+        build.dictionary = true;
+        benchmarkPackage("ZSTD + dictionary", output / "dictionary.pak", build);
+
+        fs::remove_all(output);
+    }
+};
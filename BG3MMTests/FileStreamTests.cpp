@@ -229,6 +229,40 @@ public:
         );
     }
 
+    TEST_METHOD(TestSeekCurrentAfterReadAt)
+    {
+        auto path = tempFile("fs_seek_current_read_at.bin");
+
+        constexpr size_t BLOCK = 1 << 16u; // 64KB
+        constexpr size_t FILE_SIZE = 3 * BLOCK;
+
+        // Seed file
+        {
+            std::ofstream ofs(path, std::ios::binary);
+            for (auto i = 0u; i < FILE_SIZE; ++i) {
+                auto c = static_cast<char>('A' + (i % 26));
+                ofs.write(&c, 1);
+            }
+        }
+
+        FileStream fs;
+        fs.open(path.c_str(), "rb");
+
+        char c;
+        fs.read(&c, 1);
+
+        // A positional read near the end must not move the logical position
+        char tail[16];
+        Assert::AreEqual(sizeof(tail), fs.readAt(FILE_SIZE - sizeof(tail), tail, sizeof(tail)));
+
+        // Seek relative past the buffered block
+        fs.seek(BLOCK + 10, SeekMode::Current);
+        Assert::AreEqual(BLOCK + 11, fs.tell());
+
+        fs.read(&c, 1);
+        Assert::AreEqual(static_cast<char>('A' + ((BLOCK + 11) % 26)), c);
+    }
+
     TEST_METHOD(TestWriteCrossesBlockBoundary)
     {
         auto path = tempFile("fs_write_cross_block.bin");
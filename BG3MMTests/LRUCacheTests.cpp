@@ -0,0 +1,91 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "LRUCache.h"
+
+#include <CppUnitTest.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace { // anonymous namespace
+
+using StringCache = LRUCache<int, std::string>;
+
+StringCache::ValuePtr makeValue(size_t size)
+{
+    return std::make_shared<std::string>(size, 'x');
+}
+
+} // anonymous namespace
+
+TEST_CLASS(LRUCacheTests)
+{
+public:
+    TEST_METHOD(TestHitsAndMisses)
+    {
+        StringCache cache(100);
+
+        Assert::IsNull(cache.get(1).get());
+
+        cache.put(1, makeValue(10), 10);
+        Assert::IsNotNull(cache.get(1).get());
+        Assert::IsNotNull(cache.get(1).get());
+
+        Assert::AreEqual<size_t>(2, cache.hits());
+        Assert::AreEqual<size_t>(1, cache.misses());
+        Assert::AreEqual<size_t>(10, cache.size());
+    }
+
+    TEST_METHOD(TestEvictsLeastRecentlyUsed)
+    {
+        StringCache cache(100);
+
+        cache.put(1, makeValue(40), 40);
+        cache.put(2, makeValue(40), 40);
+
+        // Touch 1 so that 2 becomes the eviction candidate
+        cache.get(1);
+        cache.put(3, makeValue(40), 40);
+
+        Assert::IsNotNull(cache.get(1).get());
+        Assert::IsNull(cache.get(2).get());
+        Assert::IsNotNull(cache.get(3).get());
+        Assert::AreEqual<size_t>(80, cache.size());
+        Assert::AreEqual<size_t>(2, cache.count());
+    }
+
+    TEST_METHOD(TestReplaceAndOversized)
+    {
+        StringCache cache(100);
+
+        cache.put(1, makeValue(40), 40);
+        cache.put(1, makeValue(60), 60);
+        Assert::AreEqual<size_t>(60, cache.size());
+        Assert::AreEqual<size_t>(60, cache.get(1)->size());
+
+        // Values larger than the whole budget are never cached
+        cache.put(2, makeValue(200), 200);
+        Assert::IsNull(cache.get(2).get());
+        Assert::AreEqual<size_t>(60, cache.size());
+    }
+
+    TEST_METHOD(TestEvictedValuesStayAlive)
+    {
+        StringCache cache(50);
+
+        auto held = cache.getOrLoad(1, [] { return std::make_pair(makeValue(50), size_t{50}); });
+        cache.put(2, makeValue(50), 50);
+
+        Assert::IsNull(cache.get(1).get());
+        Assert::AreEqual<size_t>(50, held->size());
+
+        auto loads = 0;
+        auto loader = [&] {
+            ++loads;
+            return std::make_pair(makeValue(10), size_t{10});
+        };
+
+        cache.getOrLoad(3, loader);
+        cache.getOrLoad(3, loader);
+        Assert::AreEqual(1, loads);
+    }
+};
@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "LSFReader.h"
+#include "LSFWriter.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+#include <map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+
+namespace { // anonymous namespace
+
+LSNode::Ptr makeNode(const std::string& name, int32_t index)
+{
+    auto node = std::make_shared<LSNode>();
+    node->name = name;
+
+    NodeAttribute id(FixedString);
+    id.setValue(std::format("{}_{}", name, index));
+    node->attributes["ID"] = id;
+
+    NodeAttribute count(Int);
+    count.setValue(index);
+    node->attributes["Count"] = count;
+
+    NodeAttribute position(Vec3);
+    position.setValue(std::array{1.0f * index, 2.0f, 3.0f});
+    node->attributes["Position"] = position;
+
+    return node;
+}
+
+// Two regions of nested nodes, with children of more than one name
+ByteBuffer makeLSF()
+{
+    Resource resource;
+
+    for (auto r = 0; r < 2; ++r) {
+        auto region = std::make_shared<Region>();
+        region->name = region->regionName = std::format("Region{}", r);
+
+        for (auto i = 0; i < 10; ++i) {
+            auto node = makeNode(i % 2 == 0 ? "Even" : "Odd", i);
+            for (auto j = 0; j < i % 4; ++j) {
+                node->appendChild(makeNode("Child", j));
+            }
+            region->appendChild(node);
+        }
+
+        resource.regions[region->regionName] = region;
+    }
+
+    return writeLSF(resource);
+}
+
+// Checks a document node against the tree the copying reader built for it
+void compare(const LSFDocument& document, int32_t index, const LSNode& expected)
+{
+    const auto& node = document.nodes()[index];
+    Assert::AreEqual(expected.name, std::string(document.name(node.name)));
+
+    size_t attributes = 0;
+    for (auto i = node.firstAttribute; i != -1; i = document.attributes()[i].next, ++attributes) {
+        std::string name(document.name(document.attributes()[i].name));
+
+        auto it = expected.attributes.find(name);
+        Assert::IsTrue(it != expected.attributes.end());
+        Assert::AreEqual(it->second.str(), document.value(i).str());
+        Assert::AreEqual(static_cast<int>(it->second.type()), static_cast<int>(document.value(i).type()));
+    }
+
+    Assert::AreEqual(expected.attributes.size(), attributes);
+
+    // The tree groups children by name; the document keeps them in file order
+    std::map<std::string, size_t> seen;
+    int32_t children = 0;
+
+    for (auto child = node.firstChild; child != -1; child = document.nodes()[child].nextSibling, ++children) {
+        Assert::AreEqual(index, document.nodes()[child].parent);
+
+        std::string name(document.name(document.nodes()[child].name));
+        compare(document, child, *expected.children.at(name)[seen[name]++]);
+    }
+
+    Assert::AreEqual(expected.childCount(), children);
+}
+
+} // anonymous namespace
+
+TEST_CLASS(LSFDocumentTests)
+{
+public:
+    TEST_METHOD(TestMatchesTree)
+    {
+        auto lsf = makeLSF();
+
+        LSFReader reader;
+        auto resource = reader.read(lsf);
+        auto document = reader.readDocument(lsf);
+
+        Assert::AreEqual(resource->regions.size(), document->regions().size());
+
+        for (auto region : document->regions()) {
+            Assert::AreEqual(-1, document->nodes()[region].parent);
+
+            std::string name(document->name(document->nodes()[region].name));
+            compare(*document, region, *resource->regions.at(name));
+        }
+    }
+
+    TEST_METHOD(TestEmptyDocument)
+    {
+        LSFReader reader;
+        auto document = reader.readDocument(writeLSF(Resource()));
+
+        Assert::IsTrue(document->nodes().empty());
+        Assert::IsTrue(document->regions().empty());
+    }
+};
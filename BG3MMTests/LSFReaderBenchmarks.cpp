@@ -0,0 +1,178 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "Benchmark.h"
+#include "LSFReader.h"
+#include "LSFWriter.h"
+#include "PAKReader.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+
+namespace { // anonymous namespace
+
+constexpr size_t LSF_BUDGET = 64 * 1024 * 1024; // largest set of files taken from a package
+constexpr size_t SYNTHETIC_NODES = 50000;
+constexpr size_t ITERATIONS = 5;
+
+struct LSFFile
+{
+    std::string name;
+    ByteBuffer contents;
+};
+
+NodeAttribute stringAttribute(AttributeType type, std::string value)
+{
+    NodeAttribute attr(type);
+    attr.setValue(std::move(value));
+    return attr;
+}
+
+// A level-like file: one region of many small game objects, mostly strings
+LSFFile syntheticLevel()
+{
+    std::mt19937 rng(0x15F);
+
+    auto region = std::make_shared<Region>();
+    region->name = region->regionName = "Templates";
+
+    for (size_t i = 0; i < SYNTHETIC_NODES; ++i) {
+        auto node = std::make_shared<LSNode>();
+        node->name = "GameObjects";
+
+        node->attributes["MapKey"] = stringAttribute(FixedString, std::format("{:08x}-{:04x}-{:04x}-{:04x}-{:08x}{:04x}",
+            rng(), rng() & 0xFFFF, rng() & 0xFFFF, rng() & 0xFFFF, rng(), rng() & 0xFFFF));
+        node->attributes["Name"] = stringAttribute(LSString, std::format("S_LevelObject_Generated_{}", i));
+        node->attributes["LevelName"] = stringAttribute(FixedString, "WLD_Main_A");
+        node->attributes["Type"] = stringAttribute(FixedString, i % 3 == 0 ? "item" : "character");
+
+        NodeAttribute flags(UInt);
+        flags.setValue(static_cast<uint32_t>(rng()));
+        node->attributes["Flags"] = flags;
+
+        region->appendChild(node);
+    }
+
+    Resource resource;
+    resource.regions[region->regionName] = region;
+
+    return {"synthetic level", writeLSF(resource)};
+}
+
+// The largest LSF files in the package, which in the game data are the level and merged files
+std::vector<LSFFile> packageFiles(const std::string& pakPath)
+{
+    PAKReader reader;
+    reader.read(pakPath.c_str(), true);
+
+    std::vector<const PackagedFileInfo*> candidates;
+    for (const auto& file : reader.files()) {
+        if (file.name.ends_with(".lsf")) {
+            candidates.push_back(&file);
+        }
+    }
+
+    std::ranges::sort(candidates, std::greater{}, &PackagedFileInfo::size);
+
+    std::vector<LSFFile> files;
+    size_t bytes = 0;
+
+    for (const auto* file : candidates) {
+        if (bytes + file->size() > LSF_BUDGET) {
+            continue;
+        }
+
+        files.push_back({file->name, reader.readFile(*file)});
+        bytes += file->size();
+    }
+
+    reader.close();
+
+    return files;
+}
+
+struct Measurement
+{
+    Benchmark::Result result;
+    size_t allocations;
+    size_t peak;
+};
+
+template <typename F>
+Measurement measure(F&& parse)
+{
+    Measurement measurement{};
+
+    {
+        Benchmark::PeakMemory memory;
+        parse();
+        measurement.allocations = memory.allocations();
+        measurement.peak = memory.peak();
+    }
+
+    measurement.result = Benchmark::run(ITERATIONS, parse);
+
+    return measurement;
+}
+
+} // anonymous namespace
+
+// Copying, zero-copy and flat document reads of the same files: parse time and the allocations made by one parse.
+TEST_CLASS(LSFReaderBenchmarks)
+{
+public:
+    // Set BG3MM_BENCH_PAK to a game package (Gustav.pak, a level pak) to measure its largest LSF files,
+    // or BG3MM_BENCH_SYNTHETIC to measure a generated level file
+    TEST_METHOD(BenchmarkZeroCopy)
+    {
+        auto pakPath = Benchmark::environment("BG3MM_BENCH_PAK");
+        if (pakPath.empty() && !Benchmark::synthetic()) {
+            Logger::WriteMessage("BG3MM_BENCH_PAK and BG3MM_BENCH_SYNTHETIC are not set; skipping.\n");
+            return;
+        }
+
+        std::vector<LSFFile> files;
+        if (pakPath.empty()) {
+            files.emplace_back(syntheticLevel());
+        } else {
+            files = packageFiles(pakPath);
+        }
+
+        for (const auto& file : files) {
+            // Both modes must produce the same tree
+            {
+                LSFReader copying, viewing;
+                viewing.setZeroCopy(true);
+
+                auto expected = copying.read(file.contents);
+                auto actual = viewing.read(file.contents);
+
+                compareResources(*expected, *actual);
+            }
+
+            auto copying = measure([&] {
+                return LSFReader().read(file.contents);
+            });
+
+            auto viewing = measure([&] {
+                LSFReader reader;
+                reader.setZeroCopy(true);
+                return reader.read(file.contents);
+            });
+
+            auto flat = measure([&] {
+                return LSFReader().readDocument(file.contents);
+            });
+
+            Logger::WriteMessage(std::format("{} ({} bytes)\n", file.name, file.contents.second).c_str());
+
+            for (const auto& [mode, m] : {std::pair{"copying", copying}, std::pair{"zero-copy", viewing},
+                                          std::pair{"document", flat}}) {
+                Logger::WriteMessage(std::format("  {:<10} {:>10.2f} ms/parse {:>10} allocations {:>12} peak bytes\n",
+                                                 mode, m.result.totalMs / m.result.iterations, m.allocations, m.peak).c_str());
+            }
+        }
+    }
+};
@@ -0,0 +1,124 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "Compress.h"
+#include "Exception.h"
+#include "LSFReader.h"
+#include "LSFWriter.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+
+namespace { // anonymous namespace
+
+constexpr size_t NODE_COUNT = 40000;
+
+// Enough random string data that the compressed sections are worth decompressing in parallel
+ByteBuffer makeLSF()
+{
+    std::mt19937 rng(0x24);
+
+    auto region = std::make_shared<Region>();
+    region->name = region->regionName = "Templates";
+
+    for (size_t i = 0; i < NODE_COUNT; ++i) {
+        auto node = std::make_shared<LSNode>();
+        node->name = i % 2 == 0 ? "GameObjects" : "Items";
+
+        NodeAttribute key(FixedString);
+        key.setValue(std::format("{:08x}{:08x}{:08x}{:08x}", rng(), rng(), rng(), rng()));
+        node->attributes["MapKey"] = key;
+
+        NodeAttribute flags(UInt);
+        flags.setValue(static_cast<uint32_t>(rng()));
+        node->attributes["Flags"] = flags;
+
+        region->appendChild(node);
+    }
+
+    Resource resource;
+    resource.regions[region->regionName] = region;
+
+    return writeLSF(resource);
+}
+
+// The writer stores sections uncompressed; rewrite each of them with ZSTD as the game's own files are
+ByteBuffer compressLSF(const ByteBuffer& lsf)
+{
+    auto input = Stream::makeStream(lsf);
+
+    auto magic = input.read<LSFMagic>();
+    auto header = input.read<LSFExtendedHeader>();
+    auto meta = input.read<LSFMetadataV6>();
+
+    auto compressSection = [&](uint32_t uncompressedSize, uint32_t& sizeOnDisk) {
+        if (uncompressedSize == 0) {
+            return Stream();
+        }
+
+        auto compressed = Compression::compress(CompressionMethod::ZSTD, input.data() + input.tell(),
+                                                uncompressedSize, LSCompressionLevel::DEFAULT);
+        input.seek(uncompressedSize, SeekMode::Current);
+        sizeOnDisk = static_cast<uint32_t>(compressed.size());
+
+        return compressed;
+    };
+
+    // Sections in file order
+    std::array sections{
+        compressSection(meta.stringsUncompressedSize, meta.stringsSizeOnDisk),
+        compressSection(meta.nodesUncompressedSize, meta.nodesSizeOnDisk),
+        compressSection(meta.attributesUncompressedSize, meta.attributesSizeOnDisk),
+        compressSection(meta.valuesUncompressedSize, meta.valuesSizeOnDisk),
+        compressSection(meta.keysUncompressedSize, meta.keysSizeOnDisk)
+    };
+
+    meta.compressionFlags = Compression::compressionFlags(CompressionMethod::ZSTD);
+
+    Stream output;
+    output.write(magic);
+    output.write(header);
+    output.write(meta);
+
+    for (const auto& section : sections) {
+        output.write(section.data(), section.size());
+    }
+
+    return output.detach();
+}
+
+} // anonymous namespace
+
+TEST_CLASS(LSFReaderTests)
+{
+public:
+    TEST_METHOD(TestParallelSections)
+    {
+        auto stored = makeLSF();
+        auto compressed = compressLSF(stored);
+
+        LSFReader serial;
+        serial.setParallel(false);
+
+        auto expected = serial.read(stored);
+
+        // Parallel and serial reads of the compressed file must both match the stored one
+        compareResources(*expected, *serial.read(compressed));
+        compareResources(*expected, *LSFReader().read(compressed));
+
+        auto document = LSFReader().readDocument(compressed);
+        Assert::AreEqual(NODE_COUNT + 1, document->nodes().size());
+    }
+
+    TEST_METHOD(TestTruncatedSection)
+    {
+        auto compressed = compressLSF(makeLSF());
+        compressed.second -= 16;
+
+        Assert::ExpectException<Exception>([&] {
+            LSFReader().read(compressed);
+        });
+    }
+};
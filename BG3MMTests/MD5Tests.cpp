@@ -28,6 +28,24 @@ public:
         Assert::AreEqual(std::string("e807f1fcf82d132f9bb018ca6738a19f"), hash);
     }
 
+    TEST_METHOD(TestMD5Incremental)
+    {
+        // update/finalize on a fresh instance must match a one-shot digest
+        MD5 md5;
+        md5.update(reinterpret_cast<const uint8_t*>("Hello, "), 7);
+        md5.update(reinterpret_cast<const uint8_t*>("World"), 5);
+
+        uint8_t digest[16];
+        md5.finalize(digest);
+
+        char buf[33];
+        for (auto i = 0; i < 16; i++) {
+            sprintf_s(buf + i * 2, 33 - i * 2, "%02x", digest[i]);
+        }
+
+        Assert::AreEqual(std::string("82bb413746aee42f89dea2b59614f9ef"), std::string(buf));
+    }
+
     TEST_METHOD(TestMD5Consistency)
     {
         MD5 md5;
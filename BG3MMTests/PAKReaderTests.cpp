@@ -0,0 +1,500 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "Exception.h"
+#include "PAKReader.h"
+#include "PAKWriter.h"
+#include "LZ4Codec.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+#include <atomic>
+#include <format>
+#include <map>
+#include <thread>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+constexpr auto NUM_FILES = 48;
+constexpr auto NUM_THREADS = 8;
+constexpr auto NUM_PASSES = 4;
+
+// Builds a package from pseudo-random, partially compressible files.
+// Every fourth file is a .wem so it is stored uncompressed.
+std::string buildPackage(const fs::path& root, CompressionMethod method, bool hash = false)
+{
+    std::mt19937 rng(0xB63);
+    PackageBuildData build;
+    build.compression = method;
+    build.hash = hash;
+
+    for (auto i = 0; i < NUM_FILES; ++i) {
+        auto ext = i % 4 == 0 ? ".wem" : ".lsx";
+        auto name = std::format("Mods/Test/file_{:03}{}", i, ext);
+        auto path = root / "input" / name;
+
+        auto size = i == 1 ? 0 : rng() % (192 * 1024);
+
+        std::vector<char> contents(size);
+        for (size_t j = 0; j < size; ++j) {
+            contents[j] = static_cast<char>(j % 64 < 48 ? 'a' + j % 26 : rng() & 0xFF);
+        }
+
+        writeFile(path, contents.data(), contents.size());
+
+        build.files.push_back({path.string(), name});
+    }
+
+    return writePackage(root / "test.pak", build);
+}
+
+// Hand-assembles a two-part package: even files are stored in split.pak, odd files in split_1.pak.
+// Returns the path of the first part and the expected contents by name.
+std::string buildSplitPackage(const fs::path& root, std::map<std::string, std::string>& expected)
+{
+    auto pakPath = (root / "split.pak").string();
+
+    FileStream parts[2];
+    parts[0].open(pakPath.c_str(), "wb");
+    parts[1].open(Package::partPath(pakPath, 1).c_str(), "wb");
+
+    parts[0].write<uint32_t>(PAK_MAGIC);
+    parts[0].write<LSPKHeader16>(LSPKHeader16{});
+
+    Stream fileList;
+
+    for (auto i = 0; i < NUM_FILES; ++i) {
+        auto name = std::format("Mods/Split/file_{:03}.lsx", i);
+        auto contents = std::format("<save part=\"{}\">{}</save>", i % 2, std::string(i * 97, 'a' + i % 26));
+
+        auto& part = parts[i % 2];
+
+        PackagedFileInfoCommon info{};
+        info.name = name;
+        info.archivePart = i % 2;
+        info.offsetInFile = part.tell();
+        info.sizeOnDisk = static_cast<uint32_t>(contents.size());
+
+        part.write(contents.data(), contents.size());
+        fileList.write<FileEntry18>(FileEntry18::fromCommon(info));
+
+        expected[name] = contents;
+    }
+
+    PackageHeaderCommon header{};
+    header.fileListOffset = parts[0].tell();
+
+    auto compressed = LZ4Codec::encode(fileList, 0, fileList.size());
+    parts[0].write<uint32_t>(NUM_FILES);
+    parts[0].write<uint32_t>(static_cast<uint32_t>(compressed.size()));
+    auto [data, size] = compressed.detach();
+    parts[0].write(data.get(), size);
+
+    header.fileListSize = static_cast<uint32_t>(parts[0].tell() - header.fileListOffset);
+    header.numParts = 2;
+
+    parts[0].seek(4, SeekMode::Begin);
+    parts[0].write<LSPKHeader16>(LSPKHeader16::fromCommon(header));
+
+    parts[0].close();
+    parts[1].close();
+
+    return pakPath;
+}
+
+bool sameContents(const ByteBuffer& a, const ByteBuffer& b)
+{
+    if (a.second != b.second) {
+        return false;
+    }
+
+    return a.second == 0 || memcmp(a.first.get(), b.first.get(), a.second) == 0;
+}
+
+void readConcurrently(const PAKReader& reader)
+{
+    const auto& files = reader.files();
+
+    std::vector<ByteBuffer> baseline;
+    for (const auto& file : files) {
+        baseline.emplace_back(reader.readFile(file));
+    }
+
+    std::atomic<int> mismatches{0};
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> threads;
+    for (auto t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            try {
+                for (auto pass = 0; pass < NUM_PASSES; ++pass) {
+                    // Each thread walks the entries with a different stride so reads interleave
+                    for (size_t k = 0; k < files.size(); ++k) {
+                        auto i = (k * (2 * t + 1) + pass) % files.size();
+                        auto contents = reader.readFile(files[i].name);
+                        if (!sameContents(contents, baseline[i])) {
+                            ++mismatches;
+                        }
+                    }
+                }
+            } catch (...) {
+                ++failures;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    Assert::AreEqual(0, failures.load());
+    Assert::AreEqual(0, mismatches.load());
+}
+
+} // anonymous namespace
+
+TEST_CLASS(PAKReaderTests)
+{
+public:
+    TEST_METHOD(TestConcurrentReadFile)
+    {
+        auto root = tempDir("pak_concurrent_read");
+        auto pakPath = buildPackage(root, CompressionMethod::LZ4);
+
+        PAKReader reader;
+        reader.read(pakPath.c_str());
+
+        Assert::AreEqual<size_t>(NUM_FILES, reader.files().size());
+
+        readConcurrently(reader);
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestConcurrentReadFileMapped)
+    {
+        auto root = tempDir("pak_concurrent_read_mapped");
+        auto pakPath = buildPackage(root, CompressionMethod::ZSTD);
+
+        PAKReader reader;
+        reader.read(pakPath.c_str(), true);
+
+        readConcurrently(reader);
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestParallelExplode)
+    {
+        auto root = tempDir("pak_parallel_explode");
+        auto pakPath = buildPackage(root, CompressionMethod::LZ4);
+
+        PAKReader reader;
+        reader.read(pakPath.c_str());
+
+        auto output = root / "output";
+        Assert::IsTrue(reader.explode(output.string().c_str(), nullptr, 4));
+
+        for (const auto& file : reader.files()) {
+            auto extracted = readFile(output / file.name);
+
+            auto contents = reader.readFile(file);
+            Assert::AreEqual(contents.second, extracted.size());
+            Assert::IsTrue(contents.second == 0 || memcmp(contents.first.get(), extracted.data(), contents.second) == 0);
+        }
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestStreamReadAfterReadAt)
+    {
+        auto root = tempDir("pak_stream_read_at");
+        auto pakPath = buildPackage(root, CompressionMethod::NONE);
+
+        FileStream stream;
+        stream.open(pakPath.c_str(), "rb");
+
+        // Positional reads must not disturb the buffered stream position
+        auto magic = stream.read<uint32_t>();
+        Assert::AreEqual(PAK_MAGIC, magic);
+
+        uint8_t buf[16];
+        Assert::AreEqual<size_t>(sizeof(buf), stream.readAt(stream.size() - sizeof(buf), buf, sizeof(buf)));
+
+        auto version = stream.read<uint32_t>();
+        Assert::AreEqual<uint32_t>(18, version);
+
+        Assert::AreEqual<size_t>(0, stream.readAt(stream.size(), buf, sizeof(buf)));
+
+        stream.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestIndexCache)
+    {
+        auto root = tempDir("pak_index_cache");
+        auto pakPath = buildPackage(root, CompressionMethod::LZ4);
+        auto indexPath = PackageIndex::cachePath(pakPath);
+        fs::remove(indexPath);
+
+        PAKReader parsed;
+        parsed.setIndexCache(true);
+        parsed.read(pakPath.c_str());
+        Assert::IsTrue(fs::exists(indexPath));
+
+        PAKReader cached;
+        cached.setIndexCache(true);
+        cached.read(pakPath.c_str());
+
+        // Name lookups are served by the index before the file list is materialized
+        for (const auto& file : parsed.files()) {
+            Assert::IsTrue(sameContents(parsed.readFile(file), cached.readFile(file.name)));
+        }
+
+        Assert::ExpectException<std::out_of_range>([&] { cached.readFile("Mods/Test/missing.lsx"); });
+
+        const auto& files = cached.files();
+        Assert::AreEqual(parsed.files().size(), files.size());
+
+        for (size_t i = 0; i < files.size(); ++i) {
+            const auto& expected = parsed.files()[i];
+            Assert::AreEqual(expected.name, files[i].name);
+            Assert::AreEqual(expected.offsetInFile, files[i].offsetInFile);
+            Assert::AreEqual(expected.sizeOnDisk, files[i].sizeOnDisk);
+            Assert::AreEqual(expected.uncompressedSize, files[i].uncompressedSize);
+            Assert::IsTrue(expected.flags == files[i].flags);
+        }
+
+        parsed.close();
+        cached.close();
+
+        // A rewritten archive must not be served from the stale index
+        buildPackage(root, CompressionMethod::ZSTD);
+
+        PAKReader rebuilt;
+        rebuilt.setIndexCache(true);
+        rebuilt.read(pakPath.c_str());
+
+        for (const auto& file : rebuilt.files()) {
+            Assert::IsTrue(file.method() == CompressionMethod::ZSTD || file.method() == CompressionMethod::NONE);
+        }
+
+        rebuilt.close();
+        fs::remove(indexPath);
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestCorruptIndexCache)
+    {
+        auto root = tempDir("pak_index_corrupt");
+        auto pakPath = buildPackage(root, CompressionMethod::LZ4);
+        auto indexPath = PackageIndex::cachePath(pakPath);
+        fs::remove(indexPath);
+
+        PAKReader parsed;
+        parsed.setIndexCache(true);
+        parsed.read(pakPath.c_str());
+
+        auto key = PackageIndex::keyFor(pakPath, parsed.package().m_header);
+        auto pristine = readFile(indexPath);
+
+        // Layout of the index file: header (magic, version, key, file count, string pool size), then
+        // the entries, the name-sorted order and the string pool
+        constexpr size_t HEADER_SIZE = 2 * sizeof(uint32_t) + sizeof(PackageIndexKey) + 2 * sizeof(uint32_t);
+        constexpr size_t ENTRY_SIZE = 2 * sizeof(uint32_t) + sizeof(uint64_t) + 4 * sizeof(uint32_t) + sizeof(uint8_t)
+            + 2 * sizeof(uint32_t);
+
+        auto corrupt = [&](size_t offset) {
+            auto contents = pristine;
+            memset(contents.data() + offset, 0xFF, sizeof(uint32_t));
+            writeFile(indexPath, contents);
+
+            // The damaged index is refused, and the reader falls back to the package's own file list
+            PackageIndex index;
+            Assert::IsFalse(index.open(indexPath, key));
+
+            PAKReader reader;
+            reader.setIndexCache(true);
+            reader.read(pakPath.c_str());
+
+            for (const auto& file : parsed.files()) {
+                Assert::IsTrue(sameContents(parsed.readFile(file), reader.readFile(file.name)));
+            }
+
+            reader.close();
+        };
+
+        corrupt(HEADER_SIZE); // name offset of the first entry
+        corrupt(HEADER_SIZE + NUM_FILES * ENTRY_SIZE); // first index of the sorted order
+
+        parsed.close();
+        fs::remove(indexPath);
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestMultiPartPackage)
+    {
+        auto root = tempDir("pak_multi_part");
+
+        std::map<std::string, std::string> expected;
+        auto pakPath = buildSplitPackage(root, expected);
+
+        for (auto mapped : {false, true}) {
+            PAKReader reader;
+            reader.read(pakPath.c_str(), mapped);
+
+            Assert::AreEqual<uint32_t>(2, reader.package().m_header.numParts);
+            Assert::AreEqual(expected.size(), reader.files().size());
+
+            for (const auto& file : reader.files()) {
+                auto contents = reader.readFileData(file);
+                const auto& want = expected[file.name];
+                Assert::AreEqual(want.size(), contents.size());
+                Assert::IsTrue(memcmp(want.data(), contents.data(), want.size()) == 0);
+            }
+
+            // A bulk scan visits every file across both parts
+            size_t scanned = 0;
+            reader.scanFiles(nullptr, [&](size_t, const PackagedFileInfo& file, const PackagedFileData& contents) {
+                const auto& want = expected[file.name];
+                Assert::AreEqual(want.size(), contents.size());
+                Assert::IsTrue(memcmp(want.data(), contents.data(), want.size()) == 0);
+                ++scanned;
+                return true;
+            });
+
+            Assert::AreEqual(expected.size(), scanned);
+
+            reader.close();
+        }
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestMissingPartIsOpenedLazily)
+    {
+        auto root = tempDir("pak_missing_part");
+
+        std::map<std::string, std::string> expected;
+        auto pakPath = buildSplitPackage(root, expected);
+        fs::remove(Package::partPath(pakPath, 1));
+
+        // Opening and reading from the first part must not touch the missing second part
+        PAKReader reader;
+        reader.read(pakPath.c_str());
+
+        auto first = reader.readFileData("Mods/Split/file_000.lsx");
+        const auto& want = expected["Mods/Split/file_000.lsx"];
+        Assert::AreEqual(want.size(), first.size());
+        Assert::IsTrue(memcmp(want.data(), first.data(), want.size()) == 0);
+
+        Assert::ExpectException<Exception>([&] { reader.readFile("Mods/Split/file_001.lsx"); });
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestReadFileIntoBuffer)
+    {
+        auto root = tempDir("pak_read_into_buffer");
+        auto pakPath = buildPackage(root, CompressionMethod::ZSTD);
+
+        for (auto mapped : {false, true}) {
+            PAKReader reader;
+            reader.read(pakPath.c_str(), mapped);
+
+            size_t largest = 0;
+            for (const auto& file : reader.files()) {
+                largest = std::max<size_t>(largest, file.size());
+            }
+
+            // One buffer serves every entry, stored and compressed alike
+            std::vector<uint8_t> buffer(largest);
+
+            for (const auto& file : reader.files()) {
+                auto size = reader.readFile(file, buffer);
+                auto expected = reader.readFile(file);
+
+                Assert::AreEqual(expected.second, size);
+                Assert::IsTrue(size == 0 || memcmp(buffer.data(), expected.first.get(), size) == 0);
+            }
+
+            std::vector<uint8_t> small(1);
+            auto& large = *std::ranges::max_element(reader.files(), {}, &PackagedFileInfo::size);
+            Assert::ExpectException<Exception>([&] { reader.readFile(large, small); });
+
+            reader.close();
+        }
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestVerify)
+    {
+        auto root = tempDir("pak_verify");
+        auto pakPath = buildPackage(root, CompressionMethod::ZSTD, true);
+
+        PackagedFileInfo stored, compressed;
+
+        {
+            PAKReader reader;
+            reader.read(pakPath.c_str());
+
+            auto result = reader.verify(nullptr, NUM_THREADS);
+            Assert::IsTrue(result.ok());
+            Assert::AreEqual(static_cast<size_t>(NUM_FILES), result.files);
+            Assert::IsTrue(result.hashChecked);
+
+            for (const auto& file : reader.files()) {
+                if (file.sizeOnDisk == 0) {
+                    continue;
+                }
+
+                (file.method() == CompressionMethod::NONE ? stored : compressed) = file;
+            }
+
+            reader.close();
+        }
+
+        auto corrupt = [&](const PackagedFileInfo& file, const char* name) {
+            auto path = (root / name).string();
+            fs::copy_file(pakPath, path, fs::copy_options::overwrite_existing);
+
+            std::fstream stream(path, std::ios::in | std::ios::out | std::ios::binary);
+            stream.seekp(static_cast<std::streamoff>(file.offsetInFile));
+            stream.write("\xFF\xFF\xFF\xFF", 4);
+            stream.close();
+
+            PAKReader reader;
+            reader.read(path.c_str());
+            auto result = reader.verify();
+            reader.close();
+
+            return result;
+        };
+
+        // A stored entry has nothing to decode, so only the archive digest catches it
+        auto result = corrupt(stored, "stored.pak");
+        Assert::IsFalse(result.ok());
+        Assert::IsTrue(result.errors.empty());
+        Assert::IsTrue(result.hashChecked);
+        Assert::IsFalse(result.hashMatches);
+
+        // A damaged frame fails to decode and is reported where it lies
+        result = corrupt(compressed, "compressed.pak");
+        Assert::IsFalse(result.ok());
+        Assert::AreEqual(static_cast<size_t>(1), result.errors.size());
+        Assert::AreEqual(compressed.name, result.errors[0].name);
+        Assert::AreEqual(compressed.offsetInFile, result.errors[0].offset);
+        Assert::IsFalse(result.hashChecked);
+
+        fs::remove_all(root);
+    }
+};
@@ -0,0 +1,595 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "Benchmark.h"
+#include "PAKReader.h"
+#include "PAKWriter.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+#include <format>
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+std::vector<PackageBuildInputFile> makeInputs(const fs::path& root, int count)
+{
+    std::mt19937 rng(0x5EED);
+    std::vector<PackageBuildInputFile> inputs;
+
+    for (auto i = 0; i < count; ++i) {
+        // Deliberately unsorted names so input order and hash order differ
+        auto name = std::format("Mods/Test/{:02}_file_{:03}.lsx", (i * 7) % count, i);
+        auto path = root / "input" / name;
+
+        auto size = rng() % (128 * 1024);
+
+        std::vector<char> contents(size);
+        for (size_t j = 0; j < size; ++j) {
+            contents[j] = static_cast<char>(j % 32 < 24 ? 'A' + j % 17 : rng() & 0xFF);
+        }
+
+        writeFile(path, contents.data(), contents.size());
+
+        inputs.push_back({path.string(), name});
+    }
+
+    return inputs;
+}
+
+// Small files sharing most of their structure, like the stats and LSX files of a mod
+std::vector<PackageBuildInputFile> makeSimilarInputs(const fs::path& root, int count)
+{
+    std::mt19937 rng(0xD1C7);
+    std::vector<PackageBuildInputFile> inputs;
+
+    for (auto i = 0; i < count; ++i) {
+        auto name = std::format("Mods/Test/Items/item_{:04}.lsx", i);
+        auto path = root / "input" / name;
+        fs::create_directories(path.parent_path());
+
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<save>\n"
+            << "  <version major=\"4\" minor=\"0\" revision=\"9\" build=\"331\"/>\n"
+            << "  <region id=\"Templates\">\n    <node id=\"Templates\">\n      <children>\n";
+
+        for (auto j = 0; j < 8 + static_cast<int>(rng() % 8); ++j) {
+            ofs << std::format("        <node id=\"GameObjects\">\n"
+                               "          <attribute id=\"MapKey\" type=\"FixedString\" value=\"{:08x}-{:04x}\"/>\n"
+                               "          <attribute id=\"Name\" type=\"LSString\" value=\"ITEM_{}_{}\"/>\n"
+                               "          <attribute id=\"Type\" type=\"FixedString\" value=\"item\"/>\n"
+                               "          <attribute id=\"Weight\" type=\"float\" value=\"{}\"/>\n"
+                               "        </node>\n", rng(), rng() & 0xFFFF, i, j, rng() % 100);
+        }
+
+        ofs << "      </children>\n    </node>\n  </region>\n</save>\n";
+
+        inputs.push_back({path.string(), name});
+    }
+
+    return inputs;
+}
+
+// Contents of the package written from the build
+std::string buildPackage(const fs::path& path, PackageBuildData build)
+{
+    return readFile(writePackage(path, std::move(build)));
+}
+
+} // anonymous namespace
+
+TEST_CLASS(PAKWriterTests)
+{
+public:
+    TEST_METHOD(TestParallelMatchesSerial)
+    {
+        auto root = tempDir("pak_writer_parallel");
+        auto inputs = makeInputs(root, 40);
+
+        for (auto method : {CompressionMethod::NONE, CompressionMethod::LZ4, CompressionMethod::ZSTD}) {
+            PackageBuildData build;
+            build.compression = method;
+            build.hash = true;
+            build.files = inputs;
+
+            build.threads = 1;
+            auto serial = buildPackage(root / "serial.pak", build);
+
+            build.threads = 4;
+            auto parallel = buildPackage(root / "parallel.pak", build);
+
+            Assert::IsFalse(serial.empty());
+            Assert::IsTrue(serial == parallel);
+        }
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestArchiveHash)
+    {
+        auto root = tempDir("pak_writer_hash");
+        auto inputs = makeInputs(root, 32);
+
+        // Expected digest: whole file contents concatenated in name order
+        auto sorted = inputs;
+        std::ranges::sort(sorted, [](const PackageBuildInputFile& a, const PackageBuildInputFile& b) {
+            return std::ranges::lexicographical_compare(a.name, b.name);
+        });
+
+        MD5 md5;
+        for (const auto& input : sorted) {
+            auto contents = readFile(input.filename);
+            md5.update(reinterpret_cast<const uint8_t*>(contents.data()), static_cast<uint32_t>(contents.size()));
+        }
+
+        uint8_t expected[16];
+        md5.finalize(expected);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::LZ4;
+        build.hash = true;
+        build.files = inputs;
+
+        auto pak = buildPackage(root / "hashed.pak", build);
+
+        LSPKHeader16 header;
+        memcpy(&header, pak.data() + sizeof(uint32_t), sizeof(header));
+
+        Assert::IsTrue(memcmp(expected, header.md5, sizeof(expected)) == 0);
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestStreamedLargeFile)
+    {
+        auto root = tempDir("pak_writer_streamed");
+        auto inputs = makeInputs(root, 8);
+
+        // A file well over the memory limit below, and twice the memory the build may use to pack it
+        constexpr size_t LARGE_SIZE = 24 * 1024 * 1024;
+        constexpr size_t PEAK_LIMIT = LARGE_SIZE / 2;
+
+        auto largePath = root / "input" / "large.bin";
+        {
+            std::mt19937 rng(42);
+            std::ofstream ofs(largePath, std::ios::binary);
+            std::vector<char> block(64 * 1024);
+            for (size_t i = 0; i < LARGE_SIZE / block.size(); ++i) {
+                for (size_t j = 0; j < block.size(); ++j) {
+                    block[j] = static_cast<char>(j % 8 == 0 ? rng() & 0xFF : 'a' + i % 26);
+                }
+                ofs.write(block.data(), static_cast<std::streamsize>(block.size()));
+            }
+        }
+
+        inputs.push_back({largePath.string(), "Mods/Test/large.bin"});
+
+        for (auto method : {CompressionMethod::ZSTD, CompressionMethod::ZLIB, CompressionMethod::LZ4}) {
+            PackageBuildData build;
+            build.compression = method;
+            build.hash = true;
+            build.files = inputs;
+
+            auto loaded = buildPackage(root / "loaded.pak", build);
+
+            build.memoryLimit = 1024 * 1024;
+            build.threads = 1; // one set of compression contexts, so the peak is the file data
+            auto streamedPath = root / "streamed.pak";
+
+            PackageBuildSummary summary;
+            {
+                PAKWriter writer(build, streamedPath.string().c_str());
+
+                Benchmark::PeakMemory memory;
+                writer.write();
+                writer.close();
+
+                // Loading the large file would take at least its whole size
+                if (Benchmark::PeakMemory::available()) {
+                    Assert::IsTrue(memory.peak() < PEAK_LIMIT);
+                }
+
+                summary = writer.summary();
+            }
+
+            auto streamed = readFile(streamedPath);
+
+            // Same archive digest whether or not the large file was streamed
+            Assert::IsTrue(memcmp(loaded.data() + offsetof(LSPKHeader16, md5) + 4,
+                                  streamed.data() + offsetof(LSPKHeader16, md5) + 4, 16) == 0);
+
+            PAKReader reader;
+            reader.read(streamedPath.string().c_str());
+
+            const auto& large = reader["Mods/Test/large.bin"];
+            if (method == CompressionMethod::LZ4) {
+                // LZ4 block entries cannot be streamed, so they are stored, and the summary says so
+                Assert::IsTrue(large.method() == CompressionMethod::NONE);
+                Assert::AreEqual<size_t>(1, summary.storedTooLarge.size());
+                Assert::AreEqual(std::string("Mods/Test/large.bin"), summary.storedTooLarge.front());
+            } else {
+                Assert::IsTrue(summary.storedTooLarge.empty());
+                Assert::IsTrue(large.method() == method);
+                Assert::IsTrue(large.sizeOnDisk < large.uncompressedSize);
+            }
+
+            for (const auto& input : inputs) {
+                auto expected = readFile(input.filename);
+
+                auto contents = reader.readFile(input.name);
+                Assert::AreEqual(expected.size(), contents.second);
+                Assert::IsTrue(expected.empty() || memcmp(expected.data(), contents.first.get(), expected.size()) == 0);
+            }
+
+            reader.close();
+        }
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestIncrementalRebuild)
+    {
+        auto root = tempDir("pak_writer_incremental");
+        auto inputs = makeInputs(root, 32);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::LZ4;
+        build.hash = true;
+        build.incremental = true;
+        build.files = inputs;
+
+        auto pakPath = root / "incremental.pak";
+        buildPackage(pakPath, build);
+
+        Assert::IsTrue(fs::exists(PackageManifest::pathFor(pakPath.string())));
+
+        // Change one file, rewrite another with identical contents and add a third
+        {
+            std::ofstream ofs(inputs[3].filename, std::ios::binary | std::ios::app);
+            ofs << "changed";
+        }
+
+        {
+            auto contents = readFile(inputs[5].filename);
+
+            std::ofstream ofs(inputs[5].filename, std::ios::binary | std::ios::trunc);
+            ofs << contents;
+        }
+
+        auto added = root / "input" / "Mods/Test/added.lsx";
+        {
+            std::ofstream ofs(added, std::ios::binary);
+            ofs << std::string(4096, 'x');
+        }
+
+        build.files = inputs;
+        build.files.push_back({added.string(), "Mods/Test/added.lsx"});
+
+        PAKWriter writer(build, pakPath.string().c_str());
+        writer.write();
+        writer.close();
+
+        // Everything but the changed file is copied, including the one rewritten with the same contents;
+        // the added file is new and cannot be
+        Assert::AreEqual(inputs.size() - 1, writer.summary().reused);
+
+        auto incremental = readFile(pakPath);
+
+        // A full build of the same inputs must produce the same archive
+        build.incremental = false;
+        auto full = buildPackage(root / "full.pak", build);
+
+        Assert::IsTrue(incremental == full);
+        Assert::IsFalse(fs::exists(pakPath.string() + ".tmp"));
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestIncrementalStaleManifest)
+    {
+        auto root = tempDir("pak_writer_incremental_stale");
+        auto inputs = makeInputs(root, 16);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::LZ4;
+        build.incremental = true;
+        build.files = inputs;
+
+        auto pakPath = root / "incremental.pak";
+        buildPackage(pakPath, build);
+
+        // Replace the package, but not its manifest, with one whose copy of a file differs
+        auto replaced = root / "input" / "replaced.lsx";
+        {
+            std::ofstream ofs(replaced, std::ios::binary);
+            ofs << std::string(fs::file_size(inputs[3].filename), 'r');
+        }
+
+        auto other = build;
+        other.incremental = false;
+        other.files[3].filename = replaced.string();
+        buildPackage(root / "other.pak", other);
+
+        fs::copy_file(root / "other.pak", pakPath, fs::copy_options::overwrite_existing);
+
+        // The manifest no longer describes the package, so nothing may be reused from it
+        PAKWriter writer(build, pakPath.string().c_str());
+        writer.write();
+        writer.close();
+
+        Assert::AreEqual<size_t>(0, writer.summary().reused);
+
+        build.incremental = false;
+        Assert::IsTrue(readFile(pakPath) == buildPackage(root / "full.pak", build));
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestRoundTrip)
+    {
+        auto root = tempDir("pak_writer_round_trip");
+        auto inputs = makeInputs(root, 24);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::LZ4;
+        build.files = inputs;
+
+        auto pakPath = root / "test.pak";
+        buildPackage(pakPath, build);
+
+        PAKReader reader;
+        reader.read(pakPath.string().c_str());
+
+        Assert::AreEqual(inputs.size(), reader.files().size());
+
+        for (const auto& input : inputs) {
+            auto expected = readFile(input.filename);
+
+            auto contents = reader.readFile(input.name);
+            Assert::AreEqual(expected.size(), contents.second);
+            Assert::IsTrue(expected.empty() || memcmp(expected.data(), contents.first.get(), expected.size()) == 0);
+        }
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestHighCompressionFileList)
+    {
+        auto root = tempDir("pak_writer_file_list");
+        auto inputs = makeInputs(root, 64);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::LZ4;
+        build.files = inputs;
+
+        auto fileListSize = [&](const fs::path& pakPath) {
+            buildPackage(pakPath, build);
+
+            PAKReader reader;
+            reader.read(pakPath.string().c_str());
+
+            Assert::AreEqual(inputs.size(), reader.files().size());
+            for (const auto& input : inputs) {
+                Assert::AreEqual(static_cast<size_t>(fs::file_size(input.filename)), reader.readFile(input.name).second);
+            }
+
+            auto size = reader.package().m_header.fileListSize;
+            reader.close();
+
+            return size;
+        };
+
+        auto fast = fileListSize(root / "default.pak");
+
+        build.compressionLevel = LSCompressionLevel::MAX;
+        auto max = fileListSize(root / "max.pak");
+
+        Assert::IsTrue(max <= fast);
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestSharedBlockRoundTrip)
+    {
+        auto root = tempDir("pak_writer_shared_blocks");
+        auto inputs = makeInputs(root, 64);
+
+        // Stored and oversized files sit alongside the shared blocks
+        for (const auto* name : {"Mods/Test/sound.wem", "Mods/Test/large.lsx"}) {
+            auto path = root / "input" / name;
+            std::ofstream ofs(path, std::ios::binary);
+            ofs << std::string(strcmp(name, "Mods/Test/sound.wem") == 0 ? 1000 : 300 * 1024, 'z');
+            inputs.push_back({path.string(), name});
+        }
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::LZ4;
+        build.sharedBlocks = true;
+        build.files = inputs;
+
+        auto pakPath = root / "shared.pak";
+        buildPackage(pakPath, build);
+
+        for (auto mapped : {false, true}) {
+            PAKReader reader;
+            reader.read(pakPath.string().c_str(), mapped);
+
+            Assert::AreEqual(inputs.size(), reader.files().size());
+
+            // The layout is marked with the private flag, never with the game's Solid flag
+            auto flags = static_cast<uint8_t>(reader.package().m_header.flags);
+            Assert::IsTrue(flags & static_cast<uint8_t>(PackageFlags::SharedBlocks));
+            Assert::IsFalse(flags & static_cast<uint8_t>(PackageFlags::Solid));
+
+            std::set<uint64_t> blocks;
+            size_t members = 0;
+            for (const auto& file : reader.files()) {
+                if (file.isBlockMember()) {
+                    blocks.insert(file.offsetInFile);
+                    ++members;
+                }
+            }
+
+            Assert::IsTrue(members > blocks.size());
+            Assert::IsFalse(reader["Mods/Test/large.lsx"].isBlockMember());
+            Assert::IsFalse(reader["Mods/Test/sound.wem"].isBlockMember());
+
+            for (const auto& input : inputs) {
+                auto expected = readFile(input.filename);
+
+                auto contents = reader.readFile(input.name);
+                Assert::AreEqual(expected.size(), contents.second);
+                Assert::IsTrue(expected.empty() || memcmp(expected.data(), contents.first.get(), expected.size()) == 0);
+            }
+
+            auto scanned = reader.scanFiles(nullptr, [&](size_t, const PackagedFileInfo& file, const PackagedFileData& contents) {
+                auto expected = reader.readFile(file);
+                Assert::AreEqual(expected.second, contents.size());
+                Assert::IsTrue(expected.second == 0 || memcmp(expected.first.get(), contents.data(), contents.size()) == 0);
+                return true;
+            });
+
+            Assert::AreEqual(inputs.size(), scanned);
+
+            reader.close();
+        }
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestDictionaryRoundTrip)
+    {
+        auto root = tempDir("pak_writer_dictionary");
+        auto inputs = makeSimilarInputs(root, 400);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::ZSTD;
+        build.files = inputs;
+
+        auto plain = buildPackage(root / "plain.pak", build);
+
+        build.dictionary = true;
+        auto trained = buildPackage(root / "dictionary.pak", build);
+
+        Assert::IsTrue(trained.size() < plain.size());
+
+        for (auto mapped : {false, true}) {
+            PAKReader reader;
+            reader.read((root / "dictionary.pak").string().c_str(), mapped);
+
+            auto flags = static_cast<uint8_t>(reader.package().m_header.flags);
+            Assert::IsTrue((flags & static_cast<uint8_t>(PackageFlags::Dictionary)) != 0);
+            Assert::AreEqual(inputs.size(), reader.files().size());
+
+            for (const auto& input : inputs) {
+                auto expected = readFile(input.filename);
+
+                auto contents = reader.readFile(input.name);
+                Assert::AreEqual(expected.size(), contents.second);
+                Assert::IsTrue(memcmp(expected.data(), contents.first.get(), expected.size()) == 0);
+            }
+
+            reader.close();
+        }
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestReaderReuseAfterDictionary)
+    {
+        auto root = tempDir("pak_writer_dictionary_reuse");
+        auto inputs = makeSimilarInputs(root, 400);
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::ZSTD;
+        build.files = inputs;
+
+        auto plainPath = writePackage(root / "plain.pak", build);
+
+        build.dictionary = true;
+        auto dictionaryPath = writePackage(root / "dictionary.pak", build);
+
+        // The same reader, reused without close() as Iconizer does, must not decode the plain
+        // package with the dictionary of the one read before it
+        PAKReader reader;
+        reader.read(dictionaryPath.c_str());
+        Assert::IsTrue(static_cast<uint8_t>(reader.package().m_header.flags)
+            & static_cast<uint8_t>(PackageFlags::Dictionary));
+
+        reader.read(plainPath.c_str());
+        Assert::IsFalse(static_cast<uint8_t>(reader.package().m_header.flags)
+            & static_cast<uint8_t>(PackageFlags::Dictionary));
+
+        for (const auto& input : inputs) {
+            auto expected = readFile(input.filename);
+
+            auto contents = reader.readFile(input.name);
+            Assert::AreEqual(expected.size(), contents.second);
+            Assert::IsTrue(memcmp(expected.data(), contents.first.get(), expected.size()) == 0);
+        }
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestAdaptiveSelection)
+    {
+        auto root = tempDir("pak_writer_adaptive");
+        auto inputs = makeSimilarInputs(root, 16);
+
+        // Already-compressed data gains nothing and should be stored as is
+        std::mt19937 rng(0xADA9);
+        for (auto i = 0; i < 4; ++i) {
+            auto name = std::format("Mods/Test/Textures/noise_{}.dds", i);
+            auto path = root / "input" / name;
+            fs::create_directories(path.parent_path());
+
+            std::string contents(32 * 1024 + i * 1000, '\0');
+            std::ranges::generate(contents, [&] { return static_cast<char>(rng() & 0xFF); });
+
+            std::ofstream ofs(path, std::ios::binary);
+            ofs << contents;
+            inputs.push_back({path.string(), name});
+        }
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::ZSTD;
+        build.adaptive = true;
+        build.files = inputs;
+
+        auto pakPath = root / "adaptive.pak";
+
+        PAKWriter writer(build, pakPath.string().c_str());
+        writer.write();
+        writer.close();
+
+        const auto& summary = writer.summary();
+        Assert::AreEqual<size_t>(4, summary.lowGain);
+        Assert::AreEqual<size_t>(4, summary[CompressionMethod::NONE].files);
+        Assert::AreEqual<size_t>(16, summary[CompressionMethod::LZ4].files + summary[CompressionMethod::ZSTD].files);
+        Assert::IsFalse(summary.format().empty());
+
+        PAKReader reader;
+        reader.read(pakPath.string().c_str());
+
+        for (const auto& input : inputs) {
+            const auto& file = reader[input.name];
+            auto stored = input.name.ends_with(".dds");
+            Assert::AreEqual(stored, file.method() == CompressionMethod::NONE);
+
+            auto expected = readFile(input.filename);
+
+            auto contents = reader.readFile(input.name);
+            Assert::AreEqual(expected.size(), contents.second);
+            Assert::IsTrue(memcmp(expected.data(), contents.first.get(), expected.size()) == 0);
+        }
+
+        reader.close();
+        fs::remove_all(root);
+    }
+};
@@ -0,0 +1,112 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "PackageVFS.h"
+#include "PAKWriter.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+#include <format>
+#include <map>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+// Packs the given files, each containing "<package>:<name>"
+std::string buildPackage(const fs::path& root, const char* package, uint8_t priority,
+                         std::initializer_list<const char*> names)
+{
+    PackageBuildData build;
+    build.compression = CompressionMethod::LZ4;
+    build.priority = priority;
+
+    for (const auto* name : names) {
+        auto path = root / package / name;
+        writeFile(path, std::format("{}:{}", package, name));
+
+        build.files.push_back({path.string(), name});
+    }
+
+    return writePackage(root / std::format("{}.pak", package), build);
+}
+
+std::string contentsOf(const PackagedFileData& data)
+{
+    return {reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+} // anonymous namespace
+
+TEST_CLASS(PackageVFSTests)
+{
+public:
+    TEST_METHOD(TestLoadOrderOverride)
+    {
+        auto root = tempDir("pak_vfs");
+
+        auto patch = buildPackage(root, "Patch", 5, {"Data/c.txt"});
+        auto base = buildPackage(root, "Base", 0, {"Data/a.txt", "Data/b.txt", "Data/c.txt"});
+        auto mod = buildPackage(root, "Mod", 0, {"Data/b.txt", "Data/c.txt", "Data/d.txt"});
+
+        PackageVFS vfs;
+        Assert::IsTrue(vfs.mount(patch.c_str()));
+        Assert::IsTrue(vfs.mount(base.c_str()));
+        Assert::IsTrue(vfs.mount(mod.c_str(), true));
+
+        Assert::AreEqual<size_t>(3, vfs.archiveCount());
+        Assert::AreEqual<size_t>(4, vfs.files().size());
+
+        // Later mounts win at equal priority; a higher priority wins regardless of order
+        Assert::AreEqual(std::string("Base:Data/a.txt"), contentsOf(vfs.readFileData("Data/a.txt")));
+        Assert::AreEqual(std::string("Mod:Data/b.txt"), contentsOf(vfs.readFileData("Data/b.txt")));
+        Assert::AreEqual(std::string("Patch:Data/c.txt"), contentsOf(vfs.readFileData("Data/c.txt")));
+        Assert::AreEqual(std::string("Mod:Data/d.txt"), contentsOf(vfs.readFileData("Data/d.txt")));
+
+        Assert::AreEqual<uint32_t>(0, vfs.find("Data/c.txt")->archive);
+        Assert::IsNull(vfs.find("Data/missing.txt"));
+        Assert::ExpectException<std::out_of_range>([&] { vfs.readFile("Data/missing.txt"); });
+
+        vfs.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestScanVisitsEffectiveFiles)
+    {
+        auto root = tempDir("pak_vfs_scan");
+
+        auto base = buildPackage(root, "Base", 0, {"Data/a.txt", "Data/b.lsx", "Data/c.lsx"});
+        auto mod = buildPackage(root, "Mod", 0, {"Data/b.lsx", "Data/d.lsx"});
+
+        PackageVFS vfs;
+        vfs.mount(base.c_str());
+        vfs.mount(mod.c_str());
+
+        auto filter = PAKReader::extensionFilter({".lsx"});
+        Assert::AreEqual<size_t>(3, vfs.countFiles(filter));
+
+        std::map<std::string, std::string> visited;
+        auto count = vfs.scanFiles(filter, [&](size_t i, const PackagedFileInfo& file, const PackagedFileData& contents) {
+            Assert::AreEqual(visited.size(), i);
+            visited[file.name] = contentsOf(contents);
+            return true;
+        });
+
+        Assert::AreEqual<size_t>(3, count);
+        Assert::AreEqual(std::string("Mod:Data/b.lsx"), visited["Data/b.lsx"]);
+        Assert::AreEqual(std::string("Base:Data/c.lsx"), visited["Data/c.lsx"]);
+        Assert::AreEqual(std::string("Mod:Data/d.lsx"), visited["Data/d.lsx"]);
+
+        // Stopping early ends the scan across all archives
+        count = vfs.scanFiles(nullptr, [](size_t, const PackagedFileInfo&, const PackagedFileData&) {
+            return false;
+        });
+
+        Assert::AreEqual<size_t>(1, count);
+
+        vfs.close();
+        fs::remove_all(root);
+    }
+};
@@ -0,0 +1,228 @@
+#include "pch.h"
+#include "UtilityBase.h"
+#include "FileStream.h"
+#include "LSFReader.h"
+#include "LSFWriter.h"
+#include "PAKReader.h"
+#include "PAKWriter.h"
+#include "ResourceConverter.h"
+#include "TestHelpers.h"
+
+#include <CppUnitTest.h>
+
+#include <format>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace TestHelpers;
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+constexpr auto NUM_FILES = 24;
+
+constexpr auto LSX_TEMPLATE = R"(<?xml version="1.0" encoding="utf-8"?>
+<save>
+    <version major="4" minor="0" revision="9" build="331" />
+    <region id="Config">
+        <node id="Config">
+            <attribute id="Name" type="LSString" value="{}" />
+            <attribute id="Count" type="int32" value="{}" />
+            <attribute id="Enabled" type="bool" value="True" />
+            <attribute id="Icon" type="path" value="Public/Test/Icons/icon_{}.dds" />
+            <attribute id="Transform" type="mat4x4" value="1 0 0 0 0 1 0 0 0 0 1 0 {} 0 0 1" />
+            <children>
+                <node id="Child">
+                    <attribute id="ID" type="FixedString" value="Child_{}" />
+                </node>
+            </children>
+        </node>
+    </region>
+</save>
+)";
+
+ByteBuffer makeLSF(int32_t index)
+{
+    auto node = std::make_shared<LSNode>();
+    node->name = "Child";
+
+    NodeAttribute id(FixedString);
+    id.setValue(std::format("Child_{}", index));
+    node->attributes["ID"] = id;
+
+    auto region = std::make_shared<Region>();
+    region->name = region->regionName = "Config";
+
+    NodeAttribute count(Int);
+    count.setValue(index);
+    region->attributes["Count"] = count;
+
+    NodeAttribute enabled(Bool);
+    enabled.setValue(true);
+    region->attributes["Enabled"] = enabled;
+
+    NodeAttribute icon(Path);
+    icon.setValue(std::format("Public/Test/Icons/icon_{}.dds", index));
+    region->attributes["Icon"] = icon;
+
+    NodeAttribute transform(Mat4);
+    transform.setValue(std::array<float, 16>{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, static_cast<float>(index), 0, 0, 1});
+    region->attributes["Transform"] = transform;
+    region->appendChild(node);
+
+    Resource resource;
+    resource.regions[region->regionName] = region;
+
+    return writeLSF(resource);
+}
+
+// A mod-like tree of LSX and LSF files in nested folders, with a file of another kind that is ignored
+std::vector<std::string> makeTree(const fs::path& root)
+{
+    std::vector<std::string> names;
+
+    for (auto i = 0; i < NUM_FILES; ++i) {
+        auto lsx = i % 2 == 0;
+        auto name = std::format("Public/Test/Folder{}/file_{:03}{}", i % 3, i, lsx ? ".lsx" : ".lsf");
+
+        if (lsx) {
+            writeFile(root / name, std::format(LSX_TEMPLATE, name, i, i, i, i));
+        } else {
+            writeFile(root / name, makeLSF(i));
+        }
+        names.push_back(name);
+    }
+
+    writeFile(root / "Public/Test/readme.txt", "not a resource");
+
+    return names;
+}
+
+// Every converted file must be an LSF carrying the values its source was written with
+void checkOutput(const fs::path& output, const std::vector<std::string>& names)
+{
+    for (auto i = 0; i < NUM_FILES; ++i) {
+        auto path = output / fs::path(names[i]).replace_extension(".lsf");
+        Assert::IsTrue(fs::exists(path));
+
+        FileStream stream;
+        stream.open(path.string().c_str(), "rb");
+
+        auto resource = LSFReader().read(stream.read());
+        const auto& region = resource->regions.at("Config");
+
+        Assert::AreEqual(std::to_string(i), region->attributes.at("Count").str());
+        Assert::IsTrue(std::get<bool>(region->attributes.at("Enabled").value()));
+        Assert::AreEqual(std::format("Public/Test/Icons/icon_{}.dds", i), region->attributes.at("Icon").str());
+
+        auto transform = std::get<std::array<float, 16>>(region->attributes.at("Transform").value());
+        Assert::AreEqual(1.0f, transform[0]);
+        Assert::AreEqual(static_cast<float>(i), transform[12]);
+        Assert::AreEqual(std::format("Child_{}", i), region->children.at("Child").front()->attributes.at("ID").str());
+    }
+
+    Assert::IsFalse(fs::exists(output / "Public/Test/readme.txt"));
+}
+
+void logThroughput(const ResourceConversionResult& result)
+{
+    Logger::WriteMessage(std::format("{} files, {} bytes in, {} bytes out: {:.1f} files/s, {:.2f} MB/s\n",
+                                     result.files, result.bytesRead, result.bytesWritten,
+                                     result.filesPerSecond(), result.megabytesPerSecond()).c_str());
+}
+
+} // anonymous namespace
+
+TEST_CLASS(ResourceConverterTests)
+{
+public:
+    TEST_METHOD(TestConvertDirectory)
+    {
+        auto root = tempDir("resource_convert_directory");
+        auto names = makeTree(root / "input");
+
+        ResourceConverter converter(4);
+        auto result = converter.convertDirectory((root / "input").string().c_str(), (root / "output").string().c_str());
+        logThroughput(result);
+
+        Assert::IsTrue(result.ok());
+        Assert::AreEqual<size_t>(NUM_FILES, result.files);
+        Assert::IsTrue(result.bytesRead > 0 && result.bytesWritten > 0);
+
+        checkOutput(root / "output", names);
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestConvertPackage)
+    {
+        auto root = tempDir("resource_convert_package");
+        auto names = makeTree(root / "input");
+
+        PackageBuildData build;
+        build.compression = CompressionMethod::ZSTD;
+        for (const auto& name : names) {
+            build.files.push_back({(root / "input" / name).string(), name});
+        }
+
+        auto pakPath = (root / "test.pak").string();
+
+        writePackage(pakPath, build);
+
+        PAKReader reader;
+        reader.read(pakPath.c_str());
+
+        ResourceConverter converter;
+        auto result = converter.convertPackage(reader, (root / "output").string().c_str());
+        logThroughput(result);
+
+        Assert::IsTrue(result.ok());
+        Assert::AreEqual<size_t>(NUM_FILES, result.files);
+
+        checkOutput(root / "output", names);
+
+        reader.close();
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestInvalidFile)
+    {
+        auto root = tempDir("resource_convert_invalid");
+        auto names = makeTree(root / "input");
+
+        writeFile(root / "input/Public/Test/broken.lsf", "not an LSF file");
+
+        ResourceConverter converter(2);
+        auto result = converter.convertDirectory((root / "input").string().c_str(), (root / "output").string().c_str());
+
+        // The broken file is reported and the rest are still converted
+        Assert::AreEqual<size_t>(NUM_FILES, result.files);
+        Assert::AreEqual<size_t>(1, result.errors.size());
+        Assert::AreEqual(std::string("Public/Test/broken.lsf"), result.errors.front().name);
+
+        checkOutput(root / "output", names);
+
+        fs::remove_all(root);
+    }
+
+    TEST_METHOD(TestSameOutput)
+    {
+        auto root = tempDir("resource_convert_same_output");
+        auto names = makeTree(root / "input");
+
+        // An LSX file beside an LSF file of the same name would overwrite its output
+        writeFile(root / "input/Public/Test/Folder1/file_001.lsx", std::format(LSX_TEMPLATE, "duplicate", -1, -1, -1, -1));
+
+        ResourceConverter converter(2);
+        auto result = converter.convertDirectory((root / "input").string().c_str(), (root / "output").string().c_str());
+
+        // The LSF file is converted and the LSX file is accounted for as skipped
+        Assert::AreEqual<size_t>(NUM_FILES, result.files);
+        Assert::AreEqual<size_t>(1, result.errors.size());
+        Assert::AreEqual(std::string("Public/Test/Folder1/file_001.lsx"), result.errors.front().name);
+        Assert::IsTrue(result.errors.front().message.find("Public/Test/Folder1/file_001.lsf") != std::string::npos);
+
+        checkOutput(root / "output", names);
+
+        fs::remove_all(root);
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "LSFWriter.h"
+#include "PAKWriter.h"
+
+#include <CppUnitTest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+// Fixtures shared by the tests and benchmarks
+namespace TestHelpers { // TestHelpers namespace
+
+// An empty directory of the given name beneath the temporary directory
+inline std::filesystem::path tempDir(const char* name)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+inline void writeFile(const std::filesystem::path& path, const char* data, size_t size)
+{
+    std::filesystem::create_directories(path.parent_path());
+
+    std::ofstream ofs(path, std::ios::binary);
+    ofs.write(data, static_cast<std::streamsize>(size));
+}
+
+inline void writeFile(const std::filesystem::path& path, const std::string& contents)
+{
+    writeFile(path, contents.data(), contents.size());
+}
+
+inline void writeFile(const std::filesystem::path& path, const ByteBuffer& contents)
+{
+    writeFile(path, reinterpret_cast<const char*>(contents.first.get()), contents.second);
+}
+
+inline std::string readFile(const std::filesystem::path& path)
+{
+    std::ifstream ifs(path, std::ios::binary);
+    return {std::istreambuf_iterator(ifs), std::istreambuf_iterator<char>()};
+}
+
+// Writes a package of the build's files and returns its path
+inline std::string writePackage(const std::filesystem::path& path, PackageBuildData build)
+{
+    auto pakPath = path.string();
+
+    PAKWriter writer(std::move(build), pakPath.c_str());
+    writer.write();
+    writer.close();
+
+    return pakPath;
+}
+
+inline ByteBuffer writeLSF(const Resource& resource)
+{
+    Stream stream;
+    LSFWriter writer;
+    writer.write(stream, resource);
+
+    return stream.detach();
+}
+
+// Node names, attribute values and children must match throughout both trees
+inline void compareNodes(const LSNode& expected, const LSNode& actual)
+{
+    using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+    Assert::AreEqual(expected.name, actual.name);
+    Assert::AreEqual(expected.attributes.size(), actual.attributes.size());
+
+    for (const auto& [name, attr] : expected.attributes) {
+        auto it = actual.attributes.find(name);
+        Assert::IsTrue(it != actual.attributes.end());
+        Assert::AreEqual(attr.str(), it->second.str());
+    }
+
+    Assert::AreEqual(expected.childCount(), actual.childCount());
+
+    for (const auto& [name, children] : expected.children) {
+        const auto& other = actual.children.at(name);
+        Assert::AreEqual(children.size(), other.size());
+        for (size_t i = 0; i < children.size(); ++i) {
+            compareNodes(*children[i], *other[i]);
+        }
+    }
+}
+
+inline void compareResources(const Resource& expected, const Resource& actual)
+{
+    using Microsoft::VisualStudio::CppUnitTestFramework::Assert;
+
+    Assert::AreEqual(expected.regions.size(), actual.regions.size());
+
+    for (const auto& [name, region] : expected.regions) {
+        compareNodes(*region, *actual.regions.at(name));
+    }
+}
+
+} // namespace TestHelpers
@@ -78,11 +78,11 @@ LRESULT BinaryFileView::OnPaint(CPaintDC dc)
 
     auto oldFont = dc.SelectFont(m_font);
 
-    auto size = m_buffer.second;
+    auto size = m_buffer->second;
     auto nstart = std::max<int>(0, rc.top / m_cyChar);
     auto nend = std::max<int>(0, std::min<int>(m_nLinesTotal - 1, (rc.bottom + m_cyChar - 1) / m_cyChar));
 
-    auto pdata = m_buffer.first.get();
+    auto pdata = m_buffer->first.get();
 
     for (auto i = nstart; i <= nend; ++i) {
         auto offset = static_cast<size_t>(i) * LINESIZE;
@@ -302,8 +302,7 @@ BOOL BinaryFileView::Write(LPCSTR text, size_t length) const
 
 BOOL BinaryFileView::Flush()
 {
-    // THIS IS A PLACEHOLDER!!!
-    m_buffer = m_stream.ReadBytes();
+    m_buffer = std::make_shared<const ByteBuffer>(m_stream.ReadBytes());
 
     auto hr = m_stream.Reset();
 
@@ -347,13 +346,13 @@ BOOL BinaryFileView::LoadFile(const CString& path)
     return TRUE;
 }
 
-BOOL BinaryFileView::LoadBuffer(const CString& /*path*/, const ByteBuffer& buffer)
+BOOL BinaryFileView::LoadBuffer(const CString& /*path*/, const BufferPtr& buffer)
 {
     m_stream.Reset();
     m_path.Empty();
 
-    Write(reinterpret_cast<LPCSTR>(buffer.first.get()), buffer.second);
-    Flush();
+    // Only the bytes are shown, so keep a reference to the caller's buffer rather than a copy
+    m_buffer = buffer;
 
     SetSizes();
 
@@ -433,7 +432,7 @@ void BinaryFileView::SetSizes()
     GetCharWidth32(dc, '0', '0', &m_cxChar);
     m_cyChar = tm.tmHeight + tm.tmExternalLeading;
 
-    auto size = m_buffer.second;
+    auto size = m_buffer->second;
 
     m_nLinesTotal = (static_cast<int>(size) + LINESIZE - 1) / LINESIZE;
     m_nDocHeight = m_nLinesTotal * m_cyChar;
@@ -36,7 +36,7 @@ public:
     // IFileView
     BOOL Create(HWND parent, _U_RECT rect = nullptr, DWORD dwStyle = 0, DWORD dwStyleEx = 0) override;
     BOOL LoadFile(const CString& path) override;
-    BOOL LoadBuffer(const CString& path, const ByteBuffer& buffer) override;
+    BOOL LoadBuffer(const CString& path, const BufferPtr& buffer) override;
     BOOL SaveFile() override;
     BOOL SaveFileAs(const CString& path) override;
     BOOL Destroy() override;
@@ -56,7 +56,7 @@ private:
     void SetSizes();
 
     CComObjectStack<UTF8Stream> m_stream;
-    ByteBuffer m_buffer;  // THIS IS A PLACEHOLDER!!!
+    BufferPtr m_buffer = std::make_shared<const ByteBuffer>(); // shared with the caller when loaded from a buffer
 
     CFont m_font;
     CBrush m_bkgndBrush;
@@ -2,7 +2,7 @@
 #include "FileViewContainer.h"
 #include "FileViewFactory.h"
 
-BOOL FileViewContainer::LoadView(const CString& path, const ByteBuffer& contents, FileViewFlags flags)
+BOOL FileViewContainer::LoadView(const CString& path, const IFileView::BufferPtr& contents, FileViewFlags flags)
 {
     CRect rc;
     GetClientRect(&rc);
@@ -183,7 +183,7 @@ IFileView::Ptr FileViewFactory::CreateFileView(HWND parent, _U_RECT rect, DWORD
     return fileView;
 }
 
-IFileView::Ptr FileViewFactory::CreateFileView(const CString& path, const ByteBuffer& contents,
+IFileView::Ptr FileViewFactory::CreateFileView(const CString& path, const IFileView::BufferPtr& contents,
                                                HWND hWndParent, _U_RECT rect, DWORD dwStyle, DWORD dwStyleEx,
                                                FileViewFlags flags)
 {
@@ -191,15 +191,15 @@ IFileView::Ptr FileViewFactory::CreateFileView(const CString& path, const ByteBu
 
     if (ImageView::IsRenderable(path)) {
         fileView = std::make_shared<ImageView>();
-    } else if (IsLocaFile(contents)) {
+    } else if (IsLocaFile(*contents)) {
         fileView = std::make_shared<LocaFileView>();
-    } else if (IsLSFFile(contents)) {
+    } else if (IsLSFFile(*contents)) {
         fileView = std::make_shared<LSFFileView>();
-    } else if (IsGR2File(contents)) {
+    } else if (IsGR2File(*contents)) {
         fileView = std::make_shared<GR2FileView>();
-    } else if (IsOsiFile(contents)) {
+    } else if (IsOsiFile(*contents)) {
         fileView = std::make_shared<OsiFileView>();
-    } else if (IsBinaryFile(contents)) {
+    } else if (IsBinaryFile(*contents)) {
         fileView = std::make_shared<BinaryFileView>();
     } else {
         auto textView = std::make_shared<TextFileView>();
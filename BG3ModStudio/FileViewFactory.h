@@ -8,7 +8,7 @@ public:
     static IFileView::Ptr CreateFileView(const CString& path, HWND parent = nullptr, _U_RECT rect = nullptr,
                                          DWORD dwStyle = 0, DWORD dwStyleEx = 0, FileViewFlags = FileViewFlags::None);
 
-    static IFileView::Ptr CreateFileView(const CString& path, const ByteBuffer& contents,
+    static IFileView::Ptr CreateFileView(const CString& path, const IFileView::BufferPtr& contents,
                                          HWND hWndParent = nullptr, _U_RECT rect = nullptr, DWORD dwStyle = 0,
                                          DWORD dwStyleEx = 0, FileViewFlags = FileViewFlags::None);
 
@@ -291,12 +291,12 @@ BOOL GR2FileView::IsText() const
     return FALSE;
 }
 
-BOOL GR2FileView::LoadBuffer(const CString& /*path*/, const ByteBuffer& buffer)
+BOOL GR2FileView::LoadBuffer(const CString& /*path*/, const BufferPtr& buffer)
 {
     GR2ModelBuilder builder;
 
     try {
-        auto grannyModel = builder.build(buffer);
+        auto grannyModel = builder.build(*buffer);
         if (!m_model.Create(m_direct3D, grannyModel)) {
             ATLTRACE(L"Failed to create D3DModel\n");
             return FALSE;
@@ -48,7 +48,7 @@ public:
     BOOL IsDirty() const override;
     BOOL IsEditable() const override;
     BOOL IsText() const override;
-    BOOL LoadBuffer(const CString& path, const ByteBuffer& buffer) override;
+    BOOL LoadBuffer(const CString& path, const BufferPtr& buffer) override;
     BOOL LoadFile(const CString& path) override;
     BOOL SaveFile() override;
     BOOL SaveFileAs(const CString& path) override;
@@ -24,13 +24,14 @@ class IFileView
 public:
     virtual ~IFileView() = default;
     using Ptr = std::shared_ptr<IFileView>;
+    using BufferPtr = std::shared_ptr<const ByteBuffer>;
 
     virtual BOOL Create(HWND parent, _U_RECT rect = nullptr, DWORD dwStyle = 0, DWORD dwStyleEx = 0) = 0;
     virtual BOOL Destroy() = 0;
     virtual BOOL IsDirty() const = 0;
     virtual BOOL IsEditable() const = 0;
     virtual BOOL IsText() const = 0;
-    virtual BOOL LoadBuffer(const CString& path, const ByteBuffer& buffer) = 0;
+    virtual BOOL LoadBuffer(const CString& path, const BufferPtr& buffer) = 0;
     virtual BOOL LoadFile(const CString& path) = 0;
     virtual BOOL SaveFile() = 0;
     virtual BOOL SaveFileAs(const CString& path) = 0;
@@ -254,9 +254,9 @@ BOOL ImageView::LoadFile(const CString& path)
     return LoadImage(image);
 }
 
-BOOL ImageView::LoadBuffer(const CString& /*path*/, const ByteBuffer& buffer)
+BOOL ImageView::LoadBuffer(const CString& /*path*/, const BufferPtr& buffer)
 {
-    if (!buffer.first || buffer.second == 0) {
+    if (!buffer || !buffer->first || buffer->second == 0) {
         ATLTRACE("Empty buffer\n");
         return FALSE;
     }
@@ -265,15 +265,15 @@ BOOL ImageView::LoadBuffer(const CString& /*path*/, const ByteBuffer& buffer)
 
     // Try DDS first
     auto hr = LoadFromDDSMemory(
-        buffer.first.get(),
-        buffer.second,
+        buffer->first.get(),
+        buffer->second,
         DirectX::DDS_FLAGS_NONE,
         nullptr,
         image
     );
 
     if (FAILED(hr)) {
-        hr = LoadFromWICMemory(buffer.first.get(), buffer.second,
+        hr = LoadFromWICMemory(buffer->first.get(), buffer->second,
                                DirectX::WIC_FLAGS_NONE,
                                nullptr, image);
         if (FAILED(hr)) {
@@ -18,7 +18,7 @@ enum NodeItemType
 typedef struct NodeItemData
 {
     NodeItemType type;
-    void* pdata;
+    int32_t node; // index in the document
 } NODEITEMDATA, *LPNODEITEMDATA;
 
 static constexpr auto COLUMN_PADDING = 12;
@@ -123,7 +123,7 @@ LRESULT LSFFileView::OnSelChanged(LPNMHDR /*pnmh*/)
     }
 
     if (data->type == NIT_REGION || data->type == NIT_NODE) {
-        AddAttributes(*static_cast<LSNode*>(data->pdata));
+        AddAttributes(data->node);
     }
 
     return 0;
@@ -253,7 +253,7 @@ BOOL LSFFileView::LoadFile(const CString& path)
     LSFReader reader;
 
     try {
-        m_resource = reader.read(file);
+        m_document = reader.readDocument(file);
         Populate();
     } catch (const Exception& e) {
         ATLTRACE("Failed to read LSF file: %s\n", e.what());
@@ -263,12 +263,12 @@ BOOL LSFFileView::LoadFile(const CString& path)
     return TRUE;
 }
 
-BOOL LSFFileView::LoadBuffer(const CString& /*path*/, const ByteBuffer& buffer)
+BOOL LSFFileView::LoadBuffer(const CString& /*path*/, const BufferPtr& buffer)
 {
     LSFReader reader;
 
     try {
-        m_resource = reader.read(buffer);
+        m_document = reader.readDocument(*buffer);
         Populate();
     } catch (const Exception& e) {
         ATLTRACE("Failed to read LSF buffer: %s\n", e.what());
@@ -333,7 +333,7 @@ void LSFFileView::Populate()
     m_tree.DeleteAllItems();
     m_list.DeleteAllItems();
 
-    if (!m_resource) {
+    if (!m_document) {
         return;
     }
 
@@ -343,15 +343,36 @@ void LSFFileView::Populate()
     tvis.itemex.mask = TVIF_CHILDREN | TVIF_IMAGE | TVIF_SELECTEDIMAGE | TVIF_EXPANDEDIMAGE | TVIF_TEXT |
         TVIF_PARAM;
 
-    for (const auto& region : m_resource->regions) {
-        auto wideName = StringHelper::fromUTF8(region.first.c_str());
-        tvis.itemex.cChildren = region.second->childCount() > 0 ? 1 : 0;
+    for (auto region : m_document->regions()) {
+        const auto& node = m_document->nodes()[region];
+        auto wideName = StringHelper::fromUTF8(std::string(m_document->name(node.name)).c_str());
+        tvis.itemex.cChildren = node.firstChild != -1 ? 1 : 0;
         tvis.itemex.pszText = const_cast<LPTSTR>(wideName.GetString());
-        tvis.itemex.lParam = std::bit_cast<LPARAM>(new NodeItemData{.type = NIT_REGION, .pdata = region.second.get()});
+        tvis.itemex.lParam = std::bit_cast<LPARAM>(new NodeItemData{.type = NIT_REGION, .node = region});
         m_tree.InsertItem(&tvis);
     }
 }
 
+std::vector<int32_t> LSFFileView::Children(int32_t node) const
+{
+    const auto& nodes = m_document->nodes();
+
+    std::vector<int32_t> children;
+    for (auto child = nodes[node].firstChild; child != -1; child = nodes[child].nextSibling) {
+        children.push_back(child);
+    }
+
+    // Group the children by name, names in order of first appearance
+    std::unordered_map<int32_t, size_t> rank;
+    for (auto child : children) {
+        rank.try_emplace(nodes[child].name, rank.size());
+    }
+
+    std::ranges::stable_sort(children, {}, [&](int32_t child) { return rank.at(nodes[child].name); });
+
+    return children;
+}
+
 void LSFFileView::Expand(const CTreeItem& item)
 {
     CWaitCursor cursor;
@@ -379,51 +400,18 @@ void LSFFileView::Expand(const CTreeItem& item)
         return;
     }
 
-    if (data->type == NIT_REGION) {
-        ExpandRegion(item, *static_cast<Region*>(data->pdata));
-    } else if (data->type == NIT_NODE) {
-        ExpandNode(item, *static_cast<LSNode*>(data->pdata));
+    if (data->type == NIT_REGION || data->type == NIT_NODE) {
+        ExpandNode(item, data->node);
     }
 }
 
-void LSFFileView::ExpandRegion(const CTreeItem& item, const Region& region)
+void LSFFileView::ExpandNode(const CTreeItem& item, int32_t node)
 {
     auto child = item.GetChild();
 
-    if (region.childCount() == 0) {
-        TVITEMEX newItem{};
-        newItem.mask = TVIF_CHILDREN;
-        newItem.hItem = child;
-        newItem.cChildren = 0;
-        m_tree.SetItem(&newItem);
-        return;
-    }
-
-    for (const auto& nodes : region.children | std::views::values) {
-        for (const auto& node : nodes) {
-            const auto& nodeName = node->name;
-            auto wideName = StringHelper::fromUTF8(nodeName.c_str());
-            TV_INSERTSTRUCT tvis{};
-            tvis.hParent = item.m_hTreeItem;
-            tvis.hInsertAfter = TVI_LAST;
-            tvis.itemex.mask = TVIF_CHILDREN | TVIF_IMAGE | TVIF_SELECTEDIMAGE | TVIF_EXPANDEDIMAGE | TVIF_TEXT |
-                TVIF_PARAM;
-            tvis.itemex.cChildren = node->childCount() > 0 ? 1 : 0;
-            tvis.itemex.pszText = const_cast<LPTSTR>(wideName.GetString());
-            tvis.itemex.iImage = 1;
-            tvis.itemex.iSelectedImage = 1;
-            tvis.itemex.iExpandedImage = 1;
-            tvis.itemex.lParam = std::bit_cast<LPARAM>(new NodeItemData{.type = NIT_NODE, .pdata = node.get()});
-            m_tree.InsertItem(&tvis);
-        }
-    }
-}
-
-void LSFFileView::ExpandNode(const CTreeItem& item, const LSNode& node)
-{
-    auto child = item.GetChild();
+    const auto& nodes = m_document->nodes();
 
-    if (node.childCount() == 0) {
+    if (nodes[node].firstChild == -1) {
         TVITEMEX newItem{};
         newItem.mask = TVIF_CHILDREN;
         newItem.hItem = child;
@@ -432,31 +420,33 @@ void LSFFileView::ExpandNode(const CTreeItem& item, const LSNode& node)
         return;
     }
 
-    for (const auto& nodes : node.children | std::views::values) {
-        for (const auto& childNode : nodes) {
-            const auto& nodeName = childNode->name;
-            auto wideName = StringHelper::fromUTF8(nodeName.c_str());
-            TV_INSERTSTRUCT tvis{};
-            tvis.hParent = item.m_hTreeItem;
-            tvis.hInsertAfter = TVI_LAST;
-            tvis.itemex.mask = TVIF_CHILDREN | TVIF_IMAGE | TVIF_SELECTEDIMAGE | TVIF_EXPANDEDIMAGE | TVIF_TEXT |
-                TVIF_PARAM;
-            tvis.itemex.cChildren = childNode->childCount() > 0 ? 1 : 0;
-            tvis.itemex.pszText = const_cast<LPTSTR>(wideName.GetString());
-            tvis.itemex.iImage = 1;
-            tvis.itemex.iSelectedImage = 1;
-            tvis.itemex.iExpandedImage = 1;
-            tvis.itemex.lParam = std::bit_cast<LPARAM>(new NodeItemData{.type = NIT_NODE, .pdata = childNode.get()});
-            m_tree.InsertItem(&tvis);
-        }
+    for (auto childNode : Children(node)) {
+        auto wideName = StringHelper::fromUTF8(std::string(m_document->name(nodes[childNode].name)).c_str());
+        TV_INSERTSTRUCT tvis{};
+        tvis.hParent = item.m_hTreeItem;
+        tvis.hInsertAfter = TVI_LAST;
+        tvis.itemex.mask = TVIF_CHILDREN | TVIF_IMAGE | TVIF_SELECTEDIMAGE | TVIF_EXPANDEDIMAGE | TVIF_TEXT |
+            TVIF_PARAM;
+        tvis.itemex.cChildren = nodes[childNode].firstChild != -1 ? 1 : 0;
+        tvis.itemex.pszText = const_cast<LPTSTR>(wideName.GetString());
+        tvis.itemex.iImage = 1;
+        tvis.itemex.iSelectedImage = 1;
+        tvis.itemex.iExpandedImage = 1;
+        tvis.itemex.lParam = std::bit_cast<LPARAM>(new NodeItemData{.type = NIT_NODE, .node = childNode});
+        m_tree.InsertItem(&tvis);
     }
 }
 
-void LSFFileView::AddAttributes(const LSNode& node)
+void LSFFileView::AddAttributes(int32_t node)
 {
+    const auto& attributes = m_document->attributes();
+
     int index = 0;
-    for (const auto& [name, attr] : node.attributes) {
-        auto wideName = StringHelper::fromUTF8(name.c_str());
+    for (auto i = m_document->nodes()[node].firstAttribute; i != -1; i = attributes[i].next) {
+        // Values are only decoded for the node being shown
+        auto attr = m_document->value(i);
+
+        auto wideName = StringHelper::fromUTF8(std::string(m_document->name(attributes[i].name)).c_str());
         auto wideValue = StringHelper::fromUTF8(attr.str().c_str());
         auto wideType = StringHelper::fromUTF8(attr.typeStr().c_str());
         index = m_list.InsertItem(index, wideName);
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "IFileView.h"
-#include "Resource.h"
+#include "LSFDocument.h"
 
 class LSFFileView : public CWindowImpl<LSFFileView>, public IFileView
 {
@@ -32,7 +32,7 @@ public:
     // IFileView
     BOOL Create(HWND parent, _U_RECT rect = nullptr, DWORD dwStyle = 0, DWORD dwStyleEx = 0) override;
     BOOL LoadFile(const CString& path) override;
-    BOOL LoadBuffer(const CString& path, const ByteBuffer& buffer) override;
+    BOOL LoadBuffer(const CString& path, const BufferPtr& buffer) override;
     BOOL SaveFile() override;
     BOOL SaveFileAs(const CString& path) override;
     BOOL Destroy() override;
@@ -45,11 +45,11 @@ public:
     operator HWND() const override;
 
 private:
-    void AddAttributes(const LSNode& node);
+    void AddAttributes(int32_t node);
     void AutoAdjustColumns();
+    std::vector<int32_t> Children(int32_t node) const;
     void Expand(const CTreeItem& item);
-    void ExpandNode(const CTreeItem& item, const LSNode& node);
-    void ExpandRegion(const CTreeItem& item, const Region& region);
+    void ExpandNode(const CTreeItem& item, int32_t node);
     void Populate();
     void ViewValue();
 
@@ -57,6 +57,6 @@ private:
     CTreeViewCtrlEx m_tree;
     CListViewCtrl m_list;
     CSplitterWindow m_splitter;
-    Resource::Ptr m_resource;
+    LSFDocument::Ptr m_document; // node values are decoded only when a node is selected
     CString m_path;
 };
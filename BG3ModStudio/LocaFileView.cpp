@@ -151,10 +151,10 @@ BOOL LocaFileView::LoadFile(const CString& path)
     return TRUE;
 }
 
-BOOL LocaFileView::LoadBuffer(const CString& path, const ByteBuffer& buffer)
+BOOL LocaFileView::LoadBuffer(const CString& path, const BufferPtr& buffer)
 {
     try {
-        m_resource = LocaReader::Read(buffer);
+        m_resource = LocaReader::Read(*buffer);
         Populate();
     } catch (const std::exception& e) {
         ATLTRACE("Failed to read buffer: %s\n", e.what());
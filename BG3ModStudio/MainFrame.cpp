@@ -19,6 +19,7 @@
 #include "Util.h"
 #include "UUIDDlg.h"
 
+#include <algorithm>
 #include <filesystem>
 
 #include "DatabaseDlg.h"
@@ -414,7 +415,7 @@ void MainFrame::OnNewFolderHere()
 
 void MainFrame::OnPakOpen()
 {
-    FileDialogEx dlg(FileDialogEx::Open, m_hWnd, _T("pak"), nullptr, OFN_HIDEREADONLY,
+    FileDialogEx dlg(FileDialogEx::Open, m_hWnd, _T("pak"), nullptr, OFN_HIDEREADONLY | FOS_ALLOWMULTISELECT,
                      _T("Pak Files (*.pak)\0*.pak\0All Files (*.*)\0*.*\0"));
     auto hr = dlg.Construct();
     if (FAILED(hr)) {
@@ -425,20 +426,30 @@ void MainFrame::OnPakOpen()
         return;
     }
 
-    const auto& paths = dlg.paths();
+    auto paths = dlg.paths();
     if (paths.empty()) {
         return;
     }
 
     CWaitCursor wait;
-    PAKReader reader;
-    if (!reader.read(StringHelper::toUTF8(paths[0]).GetString())) {
-        AtlMessageBox(*this, L"Failed to open PAK file.", nullptr, MB_ICONERROR);
-        return;
+
+    // The dialog returns its selection in no particular order. The overlay prefers the package with the
+    // highest PAKHeader::priority, and among equal priorities the one mounted last, so mount in file name
+    // order to make ties resolve the same way every time: a later name overrides an earlier one.
+    std::ranges::sort(paths, [](const CString& a, const CString& b) {
+        return CString(PathFindFileName(a)).CompareNoCase(PathFindFileName(b)) < 0;
+    });
+
+    PackageVFS vfs;
+    for (const auto& path : paths) {
+        if (!vfs.mount(StringHelper::toUTF8(path).GetString(), true)) {
+            AtlMessageBox(*this, L"Failed to open PAK file.", nullptr, MB_ICONERROR);
+            return;
+        }
     }
 
     auto* pakDlg = new PakExplorerDlg();
-    pakDlg->SetPAKReader(std::move(reader));
+    pakDlg->SetPackageVFS(std::move(vfs));
     pakDlg->Run(*this);
 }
 
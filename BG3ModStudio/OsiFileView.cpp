@@ -210,11 +210,11 @@ BOOL OsiFileView::LoadFile(const CString& path)
     return TRUE;
 }
 
-BOOL OsiFileView::LoadBuffer(const CString& path, const ByteBuffer& buffer)
+BOOL OsiFileView::LoadBuffer(const CString& path, const BufferPtr& buffer)
 {
     try {
         OsiReader reader;
-        reader.read(buffer);
+        reader.read(*buffer);
         m_story = std::move(reader).takeStory();
     } catch (const Exception& e) {
         ATLTRACE("Failed to load Osi buffer: %s\n", e.what());
@@ -74,7 +74,9 @@ LRESULT PAKWizBuildPage::OnPAKProgress(UINT uMsg, WPARAM wParam, LPARAM lParam,
 LRESULT PAKWizBuildPage::OnPAKComplete(UINT uMsg, WPARAM wParam, LPARAM lParam, BOOL& bHandled)
 {
     if (wParam == 0) {
-        AtlMessageBox(*this, L"Package created successfully.", L"Success", MB_ICONINFORMATION);
+        CString msg;
+        msg.Format(L"Package created successfully.\n\n%s", static_cast<LPCTSTR>(m_summary));
+        AtlMessageBox(*this, msg.GetString(), L"Success", MB_ICONINFORMATION);
         SetWizardButtons(PSWIZB_FINISH);
     } else {
         auto lower = 0, upper = 0;
@@ -108,6 +110,8 @@ DWORD PAKWizBuildPage::BuildProc(LPVOID pv)
     build.version = PackageHeaderCommon::currentVersion;
     build.compression = pThis->m_pWiz->GetCompressionMethod();
     build.compressionLevel = LSCompressionLevel::DEFAULT;
+    build.adaptive = pThis->m_pWiz->GetAdaptiveCompression();
+    build.incremental = pThis->m_pWiz->GetIncrementalBuild();
 
     const auto& root = pThis->m_pWiz->GetRoot();
     auto genLoca = pThis->m_pWiz->GetGenerateLoca();
@@ -188,6 +192,8 @@ DWORD PAKWizBuildPage::BuildProc(LPVOID pv)
 
 
         writer.write();
+
+        pThis->m_summary = StringHelper::fromUTF8(writer.summary().format().c_str());
     } catch (const std::exception& e) {
         pThis->m_lastError = StringHelper::fromUTF8(e.what());
         wParam = -1;
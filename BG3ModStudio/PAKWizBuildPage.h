@@ -39,4 +39,5 @@ private:
     PAKWizard* m_pWiz;
     CProgressBarCtrl m_progress;
     CString m_lastError;
+    CString m_summary;
 };
@@ -11,8 +11,18 @@ namespace { // anonymous
 
 struct CompressionType
 {
-    CString description;
+    LPCTSTR description;
     CompressionMethod method;
+    bool adaptive;
+};
+
+// Item data of the compression list is the index of the entry here
+const CompressionType compressionTypes[] = {
+    {.description = _T("None"), .method = CompressionMethod::NONE, .adaptive = false},
+    {.description = _T("LZ4"), .method = CompressionMethod::LZ4, .adaptive = false},
+    {.description = _T("ZLib"), .method = CompressionMethod::ZLIB, .adaptive = false},
+    {.description = _T("ZSTD"), .method = CompressionMethod::ZSTD, .adaptive = false},
+    {.description = _T("Adaptive (LZ4/ZSTD)"), .method = CompressionMethod::ZSTD, .adaptive = true}
 };
 }
 
@@ -24,25 +34,22 @@ PAKWizFilePage::PAKWizFilePage(PAKWizard* pWiz, _U_STRINGorID title) : BasePage(
 
 BOOL PAKWizFilePage::OnInitDialog(HWND hWnd, LPARAM lParam)
 {
-    static const CompressionType compressionTypes[] = {
-        {.description = _T("None"), .method = CompressionMethod::NONE},
-        {.description = _T("LZ4"), .method = CompressionMethod::LZ4},
-        {.description = _T("ZLib"), .method = CompressionMethod::ZLIB},
-        {.description = _T("ZSTD"), .method = CompressionMethod::ZSTD}
-    };
-
     m_filePath = GetDlgItem(IDC_E_PAK_BUILDER);
     ATLASSERT(m_filePath.IsWindow());
 
     m_compressionList = GetDlgItem(IDC_CB_COMPRESSION);
     ATLASSERT(m_compressionList.IsWindow());
 
-    for (const auto& ct : compressionTypes) {
-        auto index = m_compressionList.AddString(ct.description);
-        m_compressionList.SetItemData(index, static_cast<DWORD_PTR>(ct.method));
+    for (auto i = 0u; i < std::size(compressionTypes); ++i) {
+        auto index = m_compressionList.AddString(compressionTypes[i].description);
+        m_compressionList.SetItemData(index, i);
     }
 
-    SelectCompressionType(CompressionMethod::LZ4);
+    SelectCompressionType(CompressionMethod::LZ4, false);
+
+    m_incremental = GetDlgItem(IDC_CHK_INCREMENTAL_BUILD);
+    ATLASSERT(m_incremental.IsWindow());
+    m_incremental.SetCheck(m_pWiz->GetIncrementalBuild() ? BST_CHECKED : BST_UNCHECKED);
 
     const auto& root = m_pWiz->GetRoot();
     auto rootSuffix = fs::path(root.GetString()).filename();
@@ -56,13 +63,13 @@ BOOL PAKWizFilePage::OnInitDialog(HWND hWnd, LPARAM lParam)
     return TRUE; // let the system set the focus
 }
 
-void PAKWizFilePage::SelectCompressionType(CompressionMethod method)
+void PAKWizFilePage::SelectCompressionType(CompressionMethod method, bool adaptive)
 {
     ATLASSERT(m_compressionList.IsWindow());
 
     for (auto i = 0; i < m_compressionList.GetCount(); ++i) {
-        auto itemData = static_cast<CompressionMethod>(m_compressionList.GetItemData(i));
-        if (itemData == method) {
+        const auto& type = compressionTypes[m_compressionList.GetItemData(i)];
+        if (type.method == method && type.adaptive == adaptive) {
             m_compressionList.SetCurSel(i);
             break;
         }
@@ -78,9 +85,19 @@ CompressionMethod PAKWizFilePage::GetCompressionMethod() const
         return CompressionMethod::NONE;
     }
 
-    auto itemData = static_cast<CompressionMethod>(m_compressionList.GetItemData(sel));
+    return compressionTypes[m_compressionList.GetItemData(sel)].method;
+}
+
+BOOL PAKWizFilePage::GetAdaptiveCompression() const
+{
+    ATLASSERT(m_compressionList.IsWindow());
 
-    return itemData;
+    auto sel = m_compressionList.GetCurSel();
+    if (sel == CB_ERR) {
+        return FALSE;
+    }
+
+    return compressionTypes[m_compressionList.GetItemData(sel)].adaptive;
 }
 
 void PAKWizFilePage::OnBrowse()
@@ -187,11 +204,19 @@ int PAKWizFilePage::OnWizardNext()
         return -1;
     }
 
+    // An existing package is kept; an incremental build reuses its unchanged files
+    auto existed = GetLastError() == ERROR_ALREADY_EXISTS;
+
     CloseHandle(hFile);
-    DeleteFile(pakPath);
+
+    if (!existed) {
+        DeleteFile(pakPath);
+    }
 
     m_pWiz->SetPAKFile(pakPath);
     m_pWiz->SetCompressionMethod(GetCompressionMethod());
+    m_pWiz->SetAdaptiveCompression(GetAdaptiveCompression());
+    m_pWiz->SetIncrementalBuild(m_incremental.GetCheck() == BST_CHECKED);
 
     return 0;
 }
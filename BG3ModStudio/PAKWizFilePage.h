@@ -19,8 +19,9 @@ public:
 
 private:
     BOOL OnInitDialog(HWND hWnd, LPARAM lParam);
-    void SelectCompressionType(CompressionMethod method);
+    void SelectCompressionType(CompressionMethod method, bool adaptive);
     CompressionMethod GetCompressionMethod() const;
+    BOOL GetAdaptiveCompression() const;
 
     BEGIN_MSG_MAP(PAKWizFilePage)
         MSG_WM_INITDIALOG(OnInitDialog)
@@ -34,4 +35,5 @@ private:
     PAKWizard* m_pWiz;
     CEdit m_filePath;
     CComboBox m_compressionList;
+    CButton m_incremental;
 };
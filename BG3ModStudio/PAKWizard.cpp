@@ -60,3 +60,23 @@ void PAKWizard::SetCompressionMethod(CompressionMethod method)
 {
     m_method = method;
 }
+
+BOOL PAKWizard::GetAdaptiveCompression() const
+{
+    return m_adaptive;
+}
+
+void PAKWizard::SetAdaptiveCompression(BOOL adaptive)
+{
+    m_adaptive = adaptive;
+}
+
+BOOL PAKWizard::GetIncrementalBuild() const
+{
+    return m_incremental;
+}
+
+void PAKWizard::SetIncrementalBuild(BOOL incremental)
+{
+    m_incremental = incremental;
+}
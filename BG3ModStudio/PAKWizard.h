@@ -22,10 +22,18 @@ public:
     CompressionMethod GetCompressionMethod() const;
     void SetCompressionMethod(CompressionMethod method);
 
+    BOOL GetAdaptiveCompression() const;
+    void SetAdaptiveCompression(BOOL adaptive);
+
+    BOOL GetIncrementalBuild() const;
+    void SetIncrementalBuild(BOOL incremental);
+
 private:
     CString m_root;
     CString m_PAKFile;
     CompressionMethod m_method = CompressionMethod::NONE;
+    BOOL m_adaptive = FALSE;
+    BOOL m_incremental = FALSE;
     BOOL m_generateLoca = TRUE;
     BOOL m_generateLSF = TRUE;
 };
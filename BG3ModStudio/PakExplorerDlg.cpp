@@ -10,9 +10,10 @@ BOOL PakExplorerDlg::OnIdle()
     return FALSE; // only want to be called once
 }
 
-void PakExplorerDlg::SetPAKReader(PAKReader&& reader)
+void PakExplorerDlg::SetPackageVFS(PackageVFS&& vfs)
 {
-    m_pakReader = std::move(reader);
+    m_cache.clear();
+    m_vfs = std::move(vfs);
 }
 
 void PakExplorerDlg::OnClose()
@@ -48,12 +49,11 @@ void PakExplorerDlg::OnContextMenu(const CWindow& wnd, const CPoint& point)
 
     CString fullPath;
     fullPath.Format(L"%s/%s", data->prefix.GetString(), name.GetString());
-    auto utf8File = StringHelper::toUTF8(fullPath);
 
     auto filter = L"All Files(*.*)\0*.*\0\0";
 
     try {
-        auto contents = m_pakReader.readFile(utf8File.GetString());
+        auto contents = ReadFile(fullPath);
 
         FileDialogEx dlg(FileDialogEx::Save, *this, nullptr, name, 0, filter);
         auto hr = dlg.Construct();
@@ -70,7 +70,7 @@ void PakExplorerDlg::OnContextMenu(const CWindow& wnd, const CPoint& point)
 
         FileStream fs;
         fs.open(utf8Filename.GetString(), "wb");
-        fs.write(contents.first.get(), contents.second);
+        fs.write(contents->first.get(), contents->second);
 
     } catch (const std::exception& e) {
         CString msg;
@@ -141,10 +141,9 @@ LRESULT PakExplorerDlg::OnTVSelChanged(LPNMHDR pnmh)
 
     CString fullPath;
     fullPath.Format(L"%s/%s", data->prefix.GetString(), name.GetString());
-    auto utf8File = StringHelper::toUTF8(fullPath);
 
     try {
-        auto contents = m_pakReader.readFile(utf8File.GetString());
+        auto contents = ReadFile(fullPath);
 
         m_fileView.LoadView(fullPath, contents, FileViewFlags::ReadOnly);
     } catch (const std::exception& e) {
@@ -189,14 +188,14 @@ void PakExplorerDlg::Populate()
 {
     CWaitCursor cursor;
 
-    m_pakReader.sortFiles();
-    auto& files = m_pakReader.files();
+    m_vfs.sortFiles();
+    auto& files = m_vfs.files();
 
     CString currentRoot;
     auto startIndex = 0u;
 
     for (auto i = 0u; i < files.size(); ++i) {
-        const auto& file = files[i];
+        const auto& file = *files[i].file;
         auto wideFile = StringHelper::fromUTF8(file.name.c_str());
         auto pos = wideFile.Find(L'/');
 
@@ -223,10 +222,14 @@ void PakExplorerDlg::Populate()
 
 void PakExplorerDlg::SetTitle()
 {
-    auto filename = StringHelper::fromUTF8(m_pakReader.filename().c_str());
-
     CString title;
-    title.Format(L"PAK Explorer - %s", filename.GetString());
+
+    if (m_vfs.archiveCount() == 1) {
+        auto filename = StringHelper::fromUTF8(m_vfs.archive(0).filename().c_str());
+        title.Format(L"PAK Explorer - %s", filename.GetString());
+    } else {
+        title.Format(L"PAK Explorer - %zu packages", m_vfs.archiveCount());
+    }
 
     SetWindowText(title);
 }
@@ -313,6 +316,23 @@ BOOL PakExplorerDlg::OnInitDialog(HWND, LPARAM lParam)
     return TRUE; // Let the system set the focus
 }
 
+PakExplorerDlg::BufferCache::ValuePtr PakExplorerDlg::ReadFile(const CString& path)
+{
+    auto utf8File = StringHelper::toUTF8(path);
+
+    const auto* entry = m_vfs.find(utf8File.GetString());
+    if (entry == nullptr) {
+        throw std::out_of_range("File not found.");
+    }
+
+    auto contents = m_cache.getOrLoad(*entry, [&] {
+        auto buffer = std::make_shared<ByteBuffer>(m_vfs.readFileData(*entry).detach());
+        return std::make_pair(BufferCache::ValuePtr(buffer), buffer->second);
+    });
+
+    return contents;
+}
+
 void PakExplorerDlg::ExpandFolders(const CTreeItem& folder)
 {
     auto child = folder.GetChild();
@@ -340,7 +360,7 @@ void PakExplorerDlg::ExpandFolders(const CTreeItem& folder)
         return;
     }
 
-    const auto& files = m_pakReader.files();
+    const auto& files = m_vfs.files();
 
     auto prefix = np->prefix;
 
@@ -349,7 +369,7 @@ void PakExplorerDlg::ExpandFolders(const CTreeItem& folder)
     auto inserted = 0;
 
     for (auto i = np->startIndex; i < np->endIndex; ++i) {
-        const auto& full = files[i].name;
+        const auto& full = files[i].file->name;
         auto wideFile = StringHelper::fromUTF8(full.c_str());
         if (wideFile.Left(prefix.GetLength()) != prefix) {
             continue;
@@ -369,7 +389,7 @@ void PakExplorerDlg::ExpandFolders(const CTreeItem& folder)
                 auto end = i;
 
                 while (end < np->endIndex) {
-                    auto nextWideFile = StringHelper::fromUTF8(files[end].name.c_str());
+                    auto nextWideFile = StringHelper::fromUTF8(files[end].file->name.c_str());
                     if (nextWideFile.Left(subPrefix.GetLength()) != subPrefix) {
                         break;
                     }
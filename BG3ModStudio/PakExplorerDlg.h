@@ -1,8 +1,9 @@
 #pragma once
 
 #include "FileViewContainer.h"
+#include "LRUCache.h"
 #include "ModelessDialog.h"
-#include "PAKReader.h"
+#include "PackageVFS.h"
 #include "resources/resource.h"
 
 enum class NodeType : uint8_t
@@ -47,7 +48,7 @@ public:
     END_UPDATE_UI_MAP()
 
     BOOL OnIdle() override;
-    void SetPAKReader(PAKReader&& reader);
+    void SetPackageVFS(PackageVFS&& vfs);
 
 private:
     LRESULT OnDelete(LPNMHDR pnmh);
@@ -66,10 +67,14 @@ private:
     BOOL OnInitDialog(HWND, LPARAM);
     void ExpandFolders(const CTreeItem& folder);
 
+    using BufferCache = LRUCache<PackageVFS::Entry, ByteBuffer, PackageVFS::EntryHash>;
+    BufferCache::ValuePtr ReadFile(const CString& path);
+
     CSplitterWindow m_splitter;
     CTreeViewCtrlEx m_treeView;
     FileViewContainer m_fileView;
-    PAKReader m_pakReader;
+    PackageVFS m_vfs;
+    BufferCache m_cache{256 * 1024 * 1024}; // decompressed entries, most recently viewed first
     CImageList m_imageList;
 
     int m_marginLeft = 0;
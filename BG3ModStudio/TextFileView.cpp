@@ -106,19 +106,19 @@ BOOL TextFileView::LoadFile(const CString& path)
     return TRUE;
 }
 
-BOOL TextFileView::LoadBuffer(const CString& path, const ByteBuffer& buffer)
+BOOL TextFileView::LoadBuffer(const CString& path, const BufferPtr& buffer)
 {
     m_stream.Reset();
     m_path.Empty();
 
     m_encoding = UNKNOWN;
 
-    if (buffer.second == 0 || buffer.first == nullptr) {
+    if (!buffer || buffer->second == 0 || buffer->first == nullptr) {
         return FALSE;
     }
 
-    auto pb = reinterpret_cast<LPSTR>(buffer.first.get());
-    size_t size = buffer.second;
+    auto pb = reinterpret_cast<LPSTR>(buffer->first.get());
+    size_t size = buffer->second;
 
     if (SkipBOM(pb, size)) {
         size -= 3;
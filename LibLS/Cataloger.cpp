@@ -54,10 +54,19 @@ void Cataloger::close()
 
 void Cataloger::catalog(const char* pakFile, const char* dbName, bool overwrite)
 {
-    m_reader.read(pakFile);
+    PackageVFS vfs;
+    vfs.mount(pakFile, true);
+
+    catalog(vfs, dbName, overwrite);
+}
+
+void Cataloger::catalog(const PackageVFS& vfs, const char* dbName, bool overwrite)
+{
+    auto isLSX = PAKReader::extensionFilter({".lsx"});
+    auto filter = PAKReader::extensionFilter({".lsx", ".lsf"});
 
     if (m_listener) {
-        m_listener->onStart(m_reader.files().size());
+        m_listener->onStart(vfs.countFiles(filter));
     }
 
     close();
@@ -68,26 +77,23 @@ void Cataloger::catalog(const char* pakFile, const char* dbName, bool overwrite)
 
     open(dbName);
 
-    auto i = 0;
-    for (const auto& file : m_reader.files()) {
+    auto count = vfs.scanFiles(filter, [&](size_t i, const PackagedFileInfo& file, const PackagedFileData& contents) {
         if (m_listener && m_listener->isCancelled()) {
-            break;
+            return false;
         }
 
-        if (file.name.ends_with("lsx") || file.name.ends_with("lsf")) {
-            if (m_listener) {
-                m_listener->onFile(i, file.name);
-            }
+        if (m_listener) {
+            m_listener->onFile(i, file.name);
         }
 
-        if (file.name.ends_with("lsx")) {
-            catalogLSXFile(file);
-        } else if (file.name.ends_with("lsf")) {
-            catalogLSFFile(file);
+        if (isLSX(file)) {
+            catalogLSXFile(file, contents);
+        } else {
+            catalogLSFFile(file, contents);
         }
 
-        ++i;
-    }
+        return true;
+    });
 
     m_objectManager.flush();
 
@@ -95,7 +101,7 @@ void Cataloger::catalog(const char* pakFile, const char* dbName, bool overwrite)
         if (m_listener->isCancelled()) {
             m_listener->onCancel();
         } else {
-            m_listener->onFinished(i);
+            m_listener->onFinished(count);
         }
     }
 }
@@ -158,10 +164,9 @@ PrefixIterator::Ptr Cataloger::getTypes() const
     return m_objectManager.getTypes();
 }
 
-void Cataloger::catalogLSXFile(const PackagedFileInfo& file)
+void Cataloger::catalogLSXFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
-    auto buffer = m_reader.readFile(file.name);
-    XmlWrapper xmlDoc(buffer);
+    XmlWrapper xmlDoc(contents.data(), contents.size());
 
     auto nodes = xmlDoc.selectNodes("//*[self::node]");
     for (const auto& xpathNode : nodes) {
@@ -219,26 +224,34 @@ void Cataloger::catalogLSXFile(const PackagedFileInfo& file)
     }
 }
 
-void Cataloger::catalogLSFFile(const PackagedFileInfo& file)
+void Cataloger::catalogLSFFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
-    auto buffer = m_reader.readFile(file.name);
-
     LSFReader reader;
-    auto resource = reader.read(buffer);
+    auto document = reader.readDocument(contents.data(), contents.size());
 
-    for (const auto& val : resource->regions | std::views::values) {
-        catalogRegion(file.name, val);
+    // Every node below a region, in file order
+    const auto& nodes = document->nodes();
+    for (int32_t i = 0; i < static_cast<int32_t>(nodes.size()); ++i) {
+        if (nodes[i].parent != -1) {
+            catalogNode(file.name, *document, i);
+        }
     }
 }
 
-void Cataloger::catalogNode(const std::string& filename, const LSNode::Ptr& node)
+void Cataloger::catalogNode(const std::string& filename, const LSFDocument& document, int32_t index)
 {
+    const auto& node = document.nodes()[index];
+    std::string type(document.name(node.name));
+
     json doc;
     doc["source_file"] = filename;
-    doc["type"] = node->name;
+    doc["type"] = type;
 
     json attributes = json::array();
-    for (const auto& [key, val] : node->attributes) {
+    for (auto i = node.firstAttribute; i != -1; i = document.attributes()[i].next) {
+        std::string key(document.name(document.attributes()[i].name));
+        auto val = document.value(i);
+
         json attr;
 
         attr["id"] = key;
@@ -265,29 +278,9 @@ void Cataloger::catalogNode(const std::string& filename, const LSNode::Ptr& node
         }
     }
 
-    if (isUUID(mapKey) && node->name == "GameObjects") {
+    if (isUUID(mapKey) && type == "GameObjects") {
         doc["attributes"] = attributes;
 
         m_objectManager.insert(mapKey, doc);
     }
-
-    for (const auto& val : node->children | std::views::values) {
-        for (const auto& childNode : val) {
-            catalogNode(filename, childNode);
-        }
-    }
-}
-
-void Cataloger::catalogNodes(const std::string& filename, const std::vector<LSNode::Ptr>& nodes)
-{
-    for (const auto& node : nodes) {
-        catalogNode(filename, node);
-    }
-}
-
-void Cataloger::catalogRegion(const std::string& fileName, const Region::Ptr& region)
-{
-    for (const auto& val : region->children | std::views::values) {
-        catalogNodes(fileName, val);
-    }
 }
@@ -1,9 +1,9 @@
 ﻿#pragma once
 
-#include "Node.h"
+#include "LSFDocument.h"
 #include "ObjectManager.h"
 #include "PageableIterator.h"
-#include "PAKReader.h"
+#include "PackageVFS.h"
 #include "ProgressListener.h"
 #include "Resource.h"
 
@@ -21,6 +21,7 @@ public:
     void open(const char* dbName);
     void close();
     void catalog(const char* pakFile, const char* dbName, bool overwrite = false);
+    void catalog(const PackageVFS& vfs, const char* dbName, bool overwrite = false);
     std::string getParent(const char* uuid) const;
     PrefixIterator::Ptr getTypes() const;
     PrefixIterator::Ptr getRoots(const char* type) const;
@@ -32,13 +33,10 @@ public:
     bool isOpen() const;
 
 private:
-    void catalogLSXFile(const PackagedFileInfo& file);
-    void catalogLSFFile(const PackagedFileInfo& file);
-    void catalogNode(const std::string& filename, const LSNode::Ptr& node);
-    void catalogNodes(const std::string& filename, const std::vector<LSNode::Ptr>& nodes);
-    void catalogRegion(const std::string& fileName, const Region::Ptr& region);
+    void catalogLSXFile(const PackagedFileInfo& file, const PackagedFileData& contents);
+    void catalogLSFFile(const PackagedFileInfo& file, const PackagedFileData& contents);
+    void catalogNode(const std::string& filename, const LSFDocument& document, int32_t index);
 
-    PAKReader m_reader;
     IFileProgressListener* m_listener = nullptr;
     ObjectManager m_objectManager;
 };
@@ -26,30 +26,79 @@ public:
             throw Exception("Invalid compression method");
         }
     }
+
+    // Compressors keep their codec contexts between calls, so each thread reuses one per method
+    static ICompressor& get(CompressionMethod method)
+    {
+        thread_local ICompressor::Ptr compressors[4];
+
+        auto index = static_cast<size_t>(method);
+        if (index >= std::size(compressors)) {
+            throw Exception("Invalid compression method");
+        }
+
+        auto& compressor = compressors[index];
+        if (compressor == nullptr) {
+            compressor = create(method);
+        }
+
+        return *compressor;
+    }
 };
 
 Stream compress(CompressionMethod method, StreamBase& input, LSCompressionLevel level)
 {
-    auto compressor = CompressorFactory::create(method);
-    return compressor->compress(input, level);
+    auto& compressor = CompressorFactory::get(method);
+    return compressor.compress(input, level);
 }
 
 Stream compress(CompressionMethod method, const uint8_t* data, size_t size, LSCompressionLevel level)
 {
-    auto compressor = CompressorFactory::create(method);
-    return compressor->compress(data, size, level);
+    auto& compressor = CompressorFactory::get(method);
+    return compressor.compress(data, size, level);
+}
+
+size_t compress(CompressionMethod method, const ChunkReader& reader, const ChunkWriter& writer,
+                LSCompressionLevel level)
+{
+    auto& compressor = CompressorFactory::get(method);
+    return compressor.compress(reader, writer, level);
+}
+
+bool canStream(CompressionMethod method)
+{
+    // PAK entries use the LZ4 block format, which must be compressed in one piece
+    return method == CompressionMethod::ZLIB || method == CompressionMethod::ZSTD;
 }
 
 Stream decompress(CompressionMethod method, StreamBase& input, size_t uncompressedSize, bool chunked)
 {
-    auto compressor = CompressorFactory::create(method);
-    return compressor->decompress(input, uncompressedSize, chunked);
+    auto& compressor = CompressorFactory::get(method);
+    return compressor.decompress(input, uncompressedSize, chunked);
 }
 
 Stream decompress(CompressionMethod method, const uint8_t* data, size_t size, size_t uncompressedSize, bool chunked)
 {
-    auto compressor = CompressorFactory::create(method);
-    return compressor->decompress(data, size, uncompressedSize, chunked);
+    auto& compressor = CompressorFactory::get(method);
+    return compressor.decompress(data, size, uncompressedSize, chunked);
+}
+
+size_t decompress(CompressionMethod method, const uint8_t* data, size_t size, std::span<uint8_t> output, bool chunked)
+{
+    auto& compressor = CompressorFactory::get(method);
+    return compressor.decompress(data, size, output, chunked);
+}
+
+Stream compress(const uint8_t* data, size_t size, const ZSTDDictionary& dictionary)
+{
+    auto& compressor = static_cast<ZSTDCompressor&>(CompressorFactory::get(CompressionMethod::ZSTD));
+    return compressor.compress(data, size, dictionary);
+}
+
+size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, const ZSTDDictionary& dictionary)
+{
+    auto& compressor = static_cast<ZSTDCompressor&>(CompressorFactory::get(CompressionMethod::ZSTD));
+    return compressor.decompress(data, size, output, dictionary);
 }
 
 CompressionFlags compressionFlags(CompressionMethod method)
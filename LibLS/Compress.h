@@ -18,12 +18,30 @@ enum class LSCompressionLevel
     MAX
 };
 
+class ZSTDDictionary;
+
 namespace Compression { // Compression namespace
+// Fills buffer with up to size bytes, returning fewer only at the end of the input
+using ChunkReader = std::function<size_t(uint8_t* buffer, size_t size)>;
+using ChunkWriter = std::function<void(const uint8_t* data, size_t size)>;
+
 Stream compress(CompressionMethod method, StreamBase& input, LSCompressionLevel level);
 Stream compress(CompressionMethod method, const uint8_t* data, size_t size, LSCompressionLevel level);
+// Compresses incrementally with bounded memory; returns the compressed size
+size_t compress(CompressionMethod method, const ChunkReader& reader, const ChunkWriter& writer,
+                LSCompressionLevel level);
+bool canStream(CompressionMethod method);
+
 Stream decompress(CompressionMethod method, StreamBase& input, size_t uncompressedSize, bool chunked = false);
 Stream decompress(CompressionMethod method, const uint8_t* data, size_t size, size_t uncompressedSize,
                   bool chunked = false);
+// Decompresses into a caller-provided buffer, e.g. one reused across entries; returns the number of bytes written
+size_t decompress(CompressionMethod method, const uint8_t* data, size_t size, std::span<uint8_t> output,
+                  bool chunked = false);
+
+// ZSTD against a shared dictionary
+Stream compress(const uint8_t* data, size_t size, const ZSTDDictionary& dictionary);
+size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, const ZSTDDictionary& dictionary);
 
 CompressionFlags compressionFlags(CompressionMethod method);
 CompressionFlags compressionFlags(LSCompressionLevel level);
@@ -12,6 +12,10 @@ public:
 
     virtual Stream compress(StreamBase& input, LSCompressionLevel level) = 0;
     virtual Stream compress(const uint8_t* data, size_t size, LSCompressionLevel level) = 0;
+    virtual size_t compress(const Compression::ChunkReader& reader, const Compression::ChunkWriter& writer,
+                            LSCompressionLevel level) = 0;
     virtual Stream decompress(StreamBase& input, size_t uncompressedSize, bool chunked = false) = 0;
     virtual Stream decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool chunked = false) = 0;
+    // Decompresses into a caller-provided buffer; returns the number of bytes written
+    virtual size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, bool chunked = false) = 0;
 };
@@ -48,7 +48,7 @@ Iconizer::Iconizer()
         throw Exception(std::format("Cannot find icon package: {}", iconPakPath.string()));
     }
 
-    m_iconReader.read(iconPakPath.string().c_str());
+    m_iconReader.read(iconPakPath.string().c_str(), true);
 }
 
 Iconizer::~Iconizer()
@@ -92,10 +92,22 @@ PageableIterator::Ptr Iconizer::newIterator(const char* key, size_t pageSize)
 
 void Iconizer::iconize(const char* pakFile, const char* dbName, bool overwrite)
 {
-    m_reader.read(pakFile);
+    m_reader.setIndexCache(true);
+    m_reader.read(pakFile, true);
+
+    auto isLSX = PAKReader::extensionFilter({".lsx"});
+    auto isDDS = PAKReader::extensionFilter({".dds"});
+
+    auto isPortrait = [&](const PackagedFileInfo& file) {
+        return isDDS(file) && file.name.find("GUI/Assets/Portraits") != std::string::npos;
+    };
+
+    auto filter = [&](const PackagedFileInfo& file) {
+        return isLSX(file) || isPortrait(file);
+    };
 
     if (m_listener) {
-        m_listener->onStart(m_reader.files().size());
+        m_listener->onStart(m_reader.countFiles(filter));
     }
 
     close();
@@ -108,37 +120,29 @@ void Iconizer::iconize(const char* pakFile, const char* dbName, bool overwrite)
 
     m_batch.Clear();
 
-    auto i = 0;
-    for (const auto& file : m_reader.files()) {
+    auto i = m_reader.scanFiles(filter, [&](size_t index, const PackagedFileInfo& file, const PackagedFileData& contents) {
         if (m_listener && m_listener->isCancelled()) {
-            break;
+            return false;
         }
 
-        auto path = fs::path(file.name);
-
-        auto extension = path.extension().string();
-        std::ranges::transform(extension, extension.begin(), tolower);
-
-        if (extension == ".lsx" || extension == ".dds") {
-            if (m_listener) {
-                m_listener->onFile(i, file.name);
-            }
+        if (m_listener) {
+            m_listener->onFile(index, file.name);
         }
 
-        if (extension == ".lsx") {
-            iconizeLSXFile(file);
-        } else if (extension == ".dds" && path.string().find("GUI/Assets/Portraits") != std::string::npos) {
-            iconizeDDSFile(file);
+        if (isLSX(file)) {
+            iconizeLSXFile(file, contents);
+        } else {
+            iconizeDDSFile(file, contents);
         }
 
-        ++i;
-
         auto count = m_batch.Count();
         if (count > 0 && count % COMMIT_SIZE == 0) {
             m_db->Write(rocksdb::WriteOptions(), &m_batch);
             m_batch.Clear();
         }
-    }
+
+        return true;
+    });
 
     m_db->Write(rocksdb::WriteOptions(), &m_batch);
     m_batch.Clear();
@@ -230,12 +234,12 @@ DirectX::ScratchImage Iconizer::loadIconTexture(const std::string& path)
 {
     for (const auto& file : m_iconReader.files()) {
         if (file.name.ends_with(path)) {
-            auto [ptr, size] = m_iconReader.readFile(file.name);
+            auto contents = m_iconReader.readFileData(file);
 
             DirectX::ScratchImage image;
             auto hr = LoadFromDDSMemory(
-                ptr.get(),
-                size,
+                contents.data(),
+                contents.size(),
                 DirectX::DDS_FLAGS_NONE,
                 nullptr,
                 image);
@@ -250,10 +254,9 @@ DirectX::ScratchImage Iconizer::loadIconTexture(const std::string& path)
     throw Exception(std::format("Cannot find icon texture: {}", path));
 }
 
-void Iconizer::iconizeLSXFile(const PackagedFileInfo& file)
+void Iconizer::iconizeLSXFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
-    auto buffer = m_reader.readFile(file.name);
-    XmlWrapper xmlDoc(buffer);
+    XmlWrapper xmlDoc(contents.data(), contents.size());
 
     auto size = xmlDoc.selectNode("//region[@id='TextureAtlasInfo']//node[@id='TextureAtlasIconSize']");
     if (size.node().empty()) {
@@ -388,7 +391,7 @@ void Iconizer::iconizeLSXFile(const PackagedFileInfo& file)
     }
 }
 
-void Iconizer::iconizeDDSFile(const PackagedFileInfo& file)
+void Iconizer::iconizeDDSFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
     fs::path p(file.name);
 
@@ -406,10 +409,8 @@ void Iconizer::iconizeDDSFile(const PackagedFileInfo& file)
         return;
     }
 
-    auto buffer = m_reader.readFile(file.name);
-
     rocksdb::Slice key(filename);
-    rocksdb::Slice value(reinterpret_cast<const char*>(buffer.first.get()), buffer.second);
+    rocksdb::Slice value(reinterpret_cast<const char*>(contents.data()), contents.size());
 
     auto s = m_batch.Put(key, value);
     if (!s.ok()) {
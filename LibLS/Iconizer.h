@@ -35,8 +35,8 @@ public:
 
 private:
     DirectX::ScratchImage loadIconTexture(const std::string& path);
-    void iconizeLSXFile(const PackagedFileInfo& file);
-    void iconizeDDSFile(const PackagedFileInfo& file);
+    void iconizeLSXFile(const PackagedFileInfo& file, const PackagedFileData& contents);
+    void iconizeDDSFile(const PackagedFileInfo& file, const PackagedFileData& contents);
 
     PAKReader m_reader, m_iconReader;
     IFileProgressListener* m_listener = nullptr;
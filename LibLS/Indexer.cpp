@@ -161,45 +161,53 @@ Indexer::Indexer()
 
 void Indexer::index(const char* pakFile, const char* dbName, bool overwrite)
 {
-    m_reader.read(pakFile);
+    PackageVFS vfs;
+    vfs.mount(pakFile, true);
+
+    index(vfs, dbName, overwrite);
+}
+
+void Indexer::index(const PackageVFS& vfs, const char* dbName, bool overwrite)
+{
+    auto isLSX = PAKReader::extensionFilter({".lsx"});
+    auto isLSF = PAKReader::extensionFilter({".lsf"});
+    auto isTXT = PAKReader::extensionFilter({".txt"});
+
+    auto filter = [&](const PackagedFileInfo& file) {
+        return isLSX(file) || isLSF(file) || isTXT(file);
+    };
 
     if (m_listener) {
-        m_listener->onStart(m_reader.files().size());
+        m_listener->onStart(vfs.countFiles(filter));
     }
 
     auto flags = overwrite ? Xapian::DB_CREATE_OR_OVERWRITE : Xapian::DB_CREATE_OR_OPEN;
 
     m_db = std::make_unique<Xapian::WritableDatabase>(dbName, flags);
 
-    static constexpr auto extensions = std::array{".lsx", ".lsf", ".txt"};
-
-    auto i = 0;
-    for (const auto& file : m_reader.files()) {
+    vfs.scanFiles(filter, [&](size_t i, const PackagedFileInfo& file, const PackagedFileData& contents) {
         if (m_listener && m_listener->isCancelled()) {
-            break;
-        }
-
-        if (std::ranges::none_of(extensions, [&](const auto& ext) { return file.name.ends_with(ext); })) {
-            ++i;
-            continue;
+            return false;
         }
 
         if (m_listener) {
             m_listener->onFile(i, file.name);
         }
 
-        if (file.name.ends_with(".lsx")) {
-            indexLSXFile(file);
-        } else if (file.name.ends_with(".lsf")) {
-            indexLSFFile(file);
-        } else if (file.name.ends_with(".txt")) {
-            indexTXTFile(file);
+        if (isLSX(file)) {
+            indexLSXFile(file, contents);
+        } else if (isLSF(file)) {
+            indexLSFFile(file, contents);
+        } else {
+            indexTXTFile(file, contents);
         }
 
-        if (++i % COMMIT_SIZE == 0) {
+        if ((i + 1) % COMMIT_SIZE == 0) {
             m_db->commit();
         }
-    }
+
+        return true;
+    });
 
     m_db->commit();
 
@@ -224,10 +232,9 @@ void Indexer::setProgressListener(IFileProgressListener* listener)
     m_listener = listener;
 }
 
-void Indexer::indexLSXFile(const PackagedFileInfo& file)
+void Indexer::indexLSXFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
-    auto buffer = m_reader.readFile(file.name);
-    XmlWrapper xmlDoc(buffer);
+    XmlWrapper xmlDoc(contents.data(), contents.size());
 
     auto nodes = xmlDoc.selectNodes("//*[self::node]");
 
@@ -287,18 +294,23 @@ void Indexer::indexLSXFile(const PackagedFileInfo& file)
     }
 }
 
-void Indexer::indexNode(const std::string& filename, const LSNode::Ptr& node)
+bool Indexer::indexNode(const std::string& filename, const LSFDocument& document, int32_t index)
 {
+    const auto& node = document.nodes()[index];
+
     std::unordered_set<std::string> terms;
 
+    std::string docType(document.name(node.name));
+
     json doc;
     doc["source_file"] = filename;
-    doc["type"] = node->name;
-
-    std::string docType = node->name;
+    doc["type"] = docType;
 
     json attributes = json::array();
-    for (const auto& [key, val] : node->attributes) {
+    for (auto i = node.firstAttribute; i != -1; i = document.attributes()[i].next) {
+        std::string key(document.name(document.attributes()[i].name));
+        auto val = document.value(i);
+
         json attr;
 
         attr["id"] = key;
@@ -317,7 +329,7 @@ void Indexer::indexNode(const std::string& filename, const LSNode::Ptr& node)
     doc["attributes"] = attributes;
 
     if (terms.empty()) {
-        return;
+        return false;
     }
 
     Xapian::Document xdoc;
@@ -331,32 +343,12 @@ void Indexer::indexNode(const std::string& filename, const LSNode::Ptr& node)
 
     m_db->add_document(xdoc);
 
-    for (const auto& val : node->children | std::views::values) {
-        for (const auto& childNode : val) {
-            indexNode(filename, childNode);
-        }
-    }
-}
-
-void Indexer::indexNodes(const std::string& filename, const std::vector<LSNode::Ptr>& nodes)
-{
-    for (const auto& node : nodes) {
-        indexNode(filename, node);
-    }
-}
-
-void Indexer::indexRegion(const std::string& fileName, const Region::Ptr& region)
-{
-    for (const auto& val : region->children | std::views::values) {
-        indexNodes(fileName, val);
-    }
+    return true;
 }
 
-void Indexer::indexTXTFile(const PackagedFileInfo& file)
+void Indexer::indexTXTFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
-    auto buffer = m_reader.readFile(file.name);
-
-    std::string text(buffer.first.get(), buffer.first.get() + buffer.second);
+    std::string text(reinterpret_cast<const char*>(contents.data()), contents.size());
 
     std::regex reEntry(R"REG(^[ \t]*new entry[ \t]+"([^"]+)")REG",
                        std::regex_constants::icase);
@@ -431,14 +423,23 @@ void Indexer::indexTXTFile(const PackagedFileInfo& file)
     flush(); // flush last block
 }
 
-void Indexer::indexLSFFile(const PackagedFileInfo& file)
+void Indexer::indexLSFFile(const PackagedFileInfo& file, const PackagedFileData& contents)
 {
-    auto buffer = m_reader.readFile(file.name);
-
     LSFReader reader;
-    auto resource = reader.read(buffer);
+    auto document = reader.readDocument(contents.data(), contents.size());
+
+    const auto& nodes = document->nodes();
 
-    for (const auto& val : resource->regions | std::views::values) {
-        indexRegion(file.name, val);
+    // The children of a region are indexed, and the children of every node that had terms.
+    // Parents precede their children, so one pass in file order replaces the recursive walk.
+    std::vector<uint8_t> descend(nodes.size());
+
+    for (int32_t i = 0; i < static_cast<int32_t>(nodes.size()); ++i) {
+        auto parent = nodes[i].parent;
+        if (parent == -1) {
+            descend[i] = 1;
+        } else if (descend[parent]) {
+            descend[i] = indexNode(file.name, *document, i);
+        }
     }
 }
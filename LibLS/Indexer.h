@@ -2,8 +2,8 @@
 
 #include <xapian.h>
 
-#include "Node.h"
-#include "PAKReader.h"
+#include "LSFDocument.h"
+#include "PackageVFS.h"
 #include "ProgressListener.h"
 #include "Resource.h"
 
@@ -14,22 +14,20 @@ public:
     virtual ~Indexer() = default;
 
     void index(const char* pakFile, const char* dbName, bool overwrite = false);
+    void index(const PackageVFS& vfs, const char* dbName, bool overwrite = false);
     void compact() const;
     void setProgressListener(IFileProgressListener* listener);
 
 private:
-    void indexLSFFile(const PackagedFileInfo& file);
-    void indexLSXFile(const PackagedFileInfo& file);
-    void indexNode(const std::string& filename, const LSNode::Ptr& node);
-    void indexNodes(const std::string& filename, const std::vector<LSNode::Ptr>& nodes);
-    void indexRegion(const std::string& fileName, const Region::Ptr& region);
-    void indexTXTFile(const PackagedFileInfo& file);
+    void indexLSFFile(const PackagedFileInfo& file, const PackagedFileData& contents);
+    void indexLSXFile(const PackagedFileInfo& file, const PackagedFileData& contents);
+    bool indexNode(const std::string& filename, const LSFDocument& document, int32_t index);
+    void indexTXTFile(const PackagedFileInfo& file, const PackagedFileData& contents);
 
     using WritableDBPtr = std::unique_ptr<Xapian::WritableDatabase>;
     WritableDBPtr m_db;
 
     Xapian::TermGenerator m_termgen;
     Xapian::SimpleStopper m_stopper;
-    PAKReader m_reader;
     IFileProgressListener* m_listener = nullptr;
 };
@@ -191,7 +191,16 @@ struct LSFNodeInfo
     int32_t nameIndex; // index of the name in the name hash
     int32_t nameOffset; // offset of the name in the hash chain
     int32_t firstAttributeIndex; // index of the first attribute of the node, -1 if none
-    std::string keyAttribute{}; // key attribute of the node
+    int32_t keyNameIndex{-1}; // name of the node's key attribute in the name hash, -1 if none
+    int32_t keyNameOffset{0};
+};
+
+// What decoding an attribute value depends on besides its bytes
+struct LSFValueFormat
+{
+    LSFVersion version;
+    PackedVersion gameVersion;
+    bool zeroCopy; // string values view the values section rather than being copied
 };
 
 struct LSFAttributeInfo
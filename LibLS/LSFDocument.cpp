@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "LSFDocument.h"
+#include "LSFReader.h"
+
+LSFDocument::LSFDocument() = default;
+
+LSFDocument::~LSFDocument() = default;
+
+const std::vector<LSFDocument::Node>& LSFDocument::nodes() const
+{
+    return m_nodes;
+}
+
+const std::vector<LSFDocument::Attribute>& LSFDocument::attributes() const
+{
+    return m_attributes;
+}
+
+const std::vector<int32_t>& LSFDocument::regions() const
+{
+    return m_regions;
+}
+
+const LSMetadata& LSFDocument::metadata() const
+{
+    return m_metadata;
+}
+
+std::string_view LSFDocument::name(int32_t index) const
+{
+    return m_names[index];
+}
+
+NodeAttribute LSFDocument::value(int32_t attribute) const
+{
+    const auto& attr = m_attributes[attribute];
+
+    m_values.seek(attr.offset, SeekMode::Begin);
+
+    return LSFReader::readAttribute(m_format, attr.type, m_values, attr.length);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "LSFCommon.h"
+#include "NodeAttribute.h"
+#include "Stream.h"
+
+// Index-based form of an LSF file, read with LSFReader::readDocument.
+// Nodes and attributes sit in contiguous arrays in file order, linked by int32 indices as in
+// LSFNodeEntryV3, with -1 meaning none. Names are views into the decoded strings section,
+// and attribute values are decoded from the values section on request; the document owns both.
+class LSFDocument
+{
+public:
+    using Ptr = std::unique_ptr<LSFDocument>;
+
+    struct Node
+    {
+        int32_t name; // index into the name table
+        int32_t parent; // -1 for a region
+        int32_t firstChild;
+        int32_t nextSibling;
+        int32_t firstAttribute;
+        int32_t keyAttribute; // name of the key attribute, -1 if the node has none
+    };
+
+    struct Attribute
+    {
+        int32_t name;
+        AttributeType type;
+        uint32_t offset; // position of the value in the values section
+        uint32_t length;
+        int32_t next; // next attribute of the same node
+    };
+
+    ~LSFDocument();
+
+    LSFDocument(const LSFDocument&) = delete;
+    LSFDocument& operator=(const LSFDocument&) = delete;
+
+    const std::vector<Node>& nodes() const;
+    const std::vector<Attribute>& attributes() const;
+    const std::vector<int32_t>& regions() const;
+    const LSMetadata& metadata() const;
+
+    std::string_view name(int32_t index) const;
+
+    // String values are views into the document and valid while it lives.
+    // Decoding moves a cursor shared by the whole document, so one thread at a time.
+    NodeAttribute value(int32_t attribute) const;
+
+private:
+    friend class LSFReader;
+    LSFDocument();
+
+    std::vector<std::string_view> m_names;
+    std::vector<Node> m_nodes;
+    std::vector<Attribute> m_attributes;
+    std::vector<int32_t> m_regions; // root nodes in file order
+    Stream m_strings;
+    mutable Stream m_values;
+    LSFValueFormat m_format{};
+    LSMetadata m_metadata{};
+};
@@ -4,6 +4,7 @@
 #include "LSCommon.h"
 #include "LSFReader.h"
 #include "Resource.h"
+#include "ThreadPool.h"
 
 LSFReader::LSFReader() = default;
 
@@ -12,6 +13,17 @@ LSFReader::~LSFReader()
 
 namespace { // anonymous namespace
 
+// Compressed bytes below which sections are decompressed one after another on the calling thread
+constexpr size_t PARALLEL_SECTIONS_MIN = 256 * 1024;
+
+// Shared by every reader. Section tasks never wait on anything, so readers running on another pool
+// can block on them safely.
+ThreadPool& sectionPool()
+{
+    static ThreadPool pool(std::min(4u, ThreadPool::threadCount(0)));
+    return pool;
+}
+
 template <typename T, size_t N>
 std::array<T, N> readArray(Stream& stream)
 {
@@ -23,6 +35,19 @@ std::array<T, N> readArray(Stream& stream)
 
     return out;
 }
+
+// The next length bytes of a section, without copying them out
+std::string_view readView(Stream& stream, size_t length)
+{
+    if (length > stream.size() - stream.tell()) {
+        throw Exception("String extends past the end of its section.");
+    }
+
+    std::string_view view(reinterpret_cast<const char*>(stream.data()) + stream.tell(), length);
+    stream.seek(static_cast<int64_t>(length), SeekMode::Current);
+
+    return view;
+}
 } // anonymous namespace
 
 Resource::Ptr LSFReader::read(const ByteBuffer& info)
@@ -32,6 +57,13 @@ Resource::Ptr LSFReader::read(const ByteBuffer& info)
     return read();
 }
 
+Resource::Ptr LSFReader::read(const uint8_t* data, size_t size)
+{
+    m_stream = Stream::makeStream(reinterpret_cast<const char*>(data), size);
+
+    return read();
+}
+
 Resource::Ptr LSFReader::read(StreamBase& stream)
 {
     m_stream = Stream::makeStream(stream);
@@ -39,38 +71,45 @@ Resource::Ptr LSFReader::read(StreamBase& stream)
     return read();
 }
 
-Resource::Ptr LSFReader::read()
+void LSFReader::setZeroCopy(bool enabled)
 {
-    readHeader();
+    m_zeroCopy = enabled;
+}
 
-    auto namesStream = decompress(m_metadata.stringsSizeOnDisk, m_metadata.stringsUncompressedSize, "strings.bin",
-                                  false);
-    readNames(namesStream);
+void LSFReader::setParallel(bool enabled)
+{
+    m_parallel = enabled;
+}
 
-    m_nodes.clear();
+LSFDocument::Ptr LSFReader::readDocument(const ByteBuffer& info)
+{
+    m_stream = Stream::makeStream(info);
 
-    auto nodesStream = decompress(m_metadata.nodesSizeOnDisk, m_metadata.nodesUncompressedSize, "nodes.bin", true);
+    return readDocument();
+}
 
-    auto hasAdjacencyData = m_version >= LSFVersion::EXTENDED_NODES
-        && m_metadata.metadataFormat == LSFMetadataFormat::KEYS_AND_ADJACENCY;
-    readNodes(nodesStream, hasAdjacencyData);
+LSFDocument::Ptr LSFReader::readDocument(const uint8_t* data, size_t size)
+{
+    m_stream = Stream::makeStream(reinterpret_cast<const char*>(data), size);
 
-    m_attributes.clear();
+    return readDocument();
+}
 
-    auto attributesStream = decompress(m_metadata.attributesSizeOnDisk, m_metadata.attributesUncompressedSize,
-                                       "attributes.bin", true);
-    if (hasAdjacencyData) {
-        readAttributesV3(attributesStream);
-    } else {
-        readAttributesV2(attributesStream);
-    }
+LSFDocument::Ptr LSFReader::readDocument(StreamBase& stream)
+{
+    m_stream = Stream::makeStream(stream);
 
-    m_values = decompress(m_metadata.valuesSizeOnDisk, m_metadata.valuesUncompressedSize, "values.bin", true);
+    return readDocument();
+}
 
-    if (m_metadata.metadataFormat == LSFMetadataFormat::KEYS_AND_ADJACENCY) {
-        auto keysStream = decompress(m_metadata.keysSizeOnDisk, m_metadata.keysUncompressedSize, "keys.bin", true);
-        readKeys(keysStream);
-    }
+LSFValueFormat LSFReader::valueFormat() const
+{
+    return {.version = m_version, .gameVersion = m_gameVersion, .zeroCopy = m_zeroCopy};
+}
+
+Resource::Ptr LSFReader::read()
+{
+    readSections();
 
     auto resource = std::make_unique<Resource>();
     resource->metadataFormat = m_metadata.metadataFormat;
@@ -82,9 +121,176 @@ Resource::Ptr LSFReader::read()
     resource->metadata.revision = m_gameVersion.revision;
     resource->metadata.buildNumber = m_gameVersion.build;
 
+    if (m_zeroCopy) {
+        resource->buffers.emplace_back(m_values.detach());
+    }
+
+    m_names.clear();
+    m_strings = Stream();
+    m_values = Stream();
+
     return resource;
 }
 
+LSFDocument::Ptr LSFReader::readDocument()
+{
+    readSections();
+
+    LSFDocument::Ptr document(new LSFDocument());
+
+    // Flatten the hash chains so that every name is a single index
+    std::vector<int32_t> chainStart;
+    chainStart.reserve(m_names.size());
+
+    for (const auto& chain : m_names) {
+        chainStart.push_back(static_cast<int32_t>(document->m_names.size()));
+        document->m_names.insert(document->m_names.end(), chain.begin(), chain.end());
+    }
+
+    auto nameOf = [&](int32_t index, int32_t offset) {
+        return chainStart[index] + offset;
+    };
+
+    auto& nodes = document->m_nodes;
+    nodes.reserve(m_nodes.size());
+
+    // Parents precede their children, so the child lists can be threaded in one pass
+    std::vector<int32_t> lastChild(m_nodes.size(), -1);
+
+    for (const auto& defn : m_nodes) {
+        auto index = static_cast<int32_t>(nodes.size());
+
+        nodes.push_back({
+            .name = nameOf(defn.nameIndex, defn.nameOffset),
+            .parent = defn.parentIndex,
+            .firstChild = -1,
+            .nextSibling = -1,
+            .firstAttribute = defn.firstAttributeIndex,
+            .keyAttribute = defn.keyNameIndex == -1 ? -1 : nameOf(defn.keyNameIndex, defn.keyNameOffset)
+        });
+
+        if (defn.parentIndex == -1) {
+            document->m_regions.push_back(index);
+            continue;
+        }
+
+        auto& last = lastChild[defn.parentIndex];
+        if (last == -1) {
+            nodes[defn.parentIndex].firstChild = index;
+        } else {
+            nodes[last].nextSibling = index;
+        }
+
+        last = index;
+    }
+
+    document->m_attributes.reserve(m_attributes.size());
+
+    for (const auto& attribute : m_attributes) {
+        document->m_attributes.push_back({
+            .name = nameOf(attribute.nameIndex, attribute.nameOffset),
+            .type = static_cast<AttributeType>(attribute.typeId),
+            .offset = attribute.dataOffset,
+            .length = attribute.length,
+            .next = attribute.nextAttributeIndex
+        });
+    }
+
+    document->m_strings = std::move(m_strings);
+    document->m_values = std::move(m_values);
+    document->m_format = valueFormat();
+    document->m_format.zeroCopy = true;
+
+    auto& metadata = document->m_metadata;
+    metadata.majorVersion = m_gameVersion.major;
+    metadata.minorVersion = m_gameVersion.minor;
+    metadata.revision = m_gameVersion.revision;
+    metadata.buildNumber = m_gameVersion.build;
+
+    m_names.clear();
+    m_strings = Stream();
+    m_values = Stream();
+
+    return document;
+}
+
+void LSFReader::readSections()
+{
+    readHeader();
+
+    auto hasKeys = m_metadata.metadataFormat == LSFMetadataFormat::KEYS_AND_ADJACENCY;
+    auto hasAdjacencyData = m_version >= LSFVersion::EXTENDED_NODES && hasKeys;
+
+    auto strings = locate(m_metadata.stringsSizeOnDisk, m_metadata.stringsUncompressedSize, "strings.bin", false);
+
+    // Decoded in this order; the values section, usually the largest, is submitted first
+    enum { NODES, ATTRIBUTES, VALUES, KEYS, SECTION_COUNT };
+
+    std::array<Section, SECTION_COUNT> sections{};
+    sections[NODES] = locate(m_metadata.nodesSizeOnDisk, m_metadata.nodesUncompressedSize, "nodes.bin", true);
+    sections[ATTRIBUTES] = locate(m_metadata.attributesSizeOnDisk, m_metadata.attributesUncompressedSize,
+                                  "attributes.bin", true);
+    sections[VALUES] = locate(m_metadata.valuesSizeOnDisk, m_metadata.valuesUncompressedSize, "values.bin", true);
+    if (hasKeys) {
+        sections[KEYS] = locate(m_metadata.keysSizeOnDisk, m_metadata.keysUncompressedSize, "keys.bin", true);
+    }
+
+    size_t compressedBytes = 0;
+    for (const auto& section : sections) {
+        compressedBytes += section.compressed ? section.sizeOnDisk : 0;
+    }
+
+    std::array<std::future<Stream>, SECTION_COUNT> pending;
+
+    if (m_parallel && compressedBytes >= PARALLEL_SECTIONS_MIN) {
+        for (auto index : {VALUES, NODES, ATTRIBUTES, KEYS}) {
+            if (sections[index].uncompressedSize != 0) {
+                pending[index] = sectionPool().submit([this, section = sections[index]] {
+                    return decompress(section);
+                });
+            }
+        }
+    }
+
+    auto load = [&](size_t index) {
+        return pending[index].valid() ? pending[index].get() : decompress(sections[index]);
+    };
+
+    m_nodes.clear();
+    m_attributes.clear();
+
+    try {
+        // The name table views this buffer, so it is kept for the whole read
+        m_strings = decompress(strings);
+        readNames(m_strings);
+
+        auto nodesStream = load(NODES);
+        readNodes(nodesStream, hasAdjacencyData);
+
+        auto attributesStream = load(ATTRIBUTES);
+        if (hasAdjacencyData) {
+            readAttributesV3(attributesStream);
+        } else {
+            readAttributesV2(attributesStream);
+        }
+
+        m_values = load(VALUES);
+
+        if (hasKeys) {
+            auto keysStream = load(KEYS);
+            readKeys(keysStream);
+        }
+    } catch (...) {
+        // The tasks read from m_stream, so none may outlive this call
+        for (auto& future : pending) {
+            if (future.valid()) {
+                future.wait();
+            }
+        }
+        throw;
+    }
+}
+
 void LSFReader::readHeader()
 {
     auto [magic, version] = m_stream.read<LSFMagic>();
@@ -145,17 +351,16 @@ void LSFReader::readNames(Stream& stream)
     m_names.clear();
 
     auto numHashEntries = stream.read<uint32_t>();
-    while (numHashEntries-- > 0) {
-        auto hash = std::vector<std::string>();
+    m_names.resize(numHashEntries);
 
+    for (auto& hash : m_names) {
         auto numStrings = stream.read<uint16_t>();
+        hash.reserve(numStrings);
+
         while (numStrings-- > 0) {
             auto nameLen = stream.read<uint16_t>();
-            auto name = readString(stream, nameLen);
-            hash.emplace_back(std::move(name));
+            hash.emplace_back(readString(stream, nameLen));
         }
-
-        m_names.emplace_back(hash);
     }
 }
 
@@ -248,9 +453,9 @@ void LSFReader::readKeys(Stream& stream)
         auto keyNameIndex = key.keyNameIndex();
         auto keyNameOffset = key.keyNameOffset();
 
-        auto keyAttribute = m_names[keyNameIndex][keyNameOffset];
         auto& node = m_nodes[key.nodeIndex];
-        node.keyAttribute = keyAttribute;
+        node.keyNameIndex = keyNameIndex;
+        node.keyNameOffset = keyNameOffset;
     }
 }
 
@@ -284,20 +489,20 @@ AttributeValue LSFReader::readVector(const NodeAttribute& attr, Stream& stream)
     return val;
 }
 
-TranslatedFSStringT LSFReader::readTranslatedFSString(Stream& stream) const
+TranslatedFSStringT LSFReader::readTranslatedFSString(const LSFValueFormat& format, Stream& stream)
 {
     TranslatedFSStringT str;
 
-    if (m_version >= LSFVersion::BG3) {
+    if (format.version >= LSFVersion::BG3) {
         str.version = stream.read<uint16_t>();
     } else {
         str.version = 0;
         auto valueLength = stream.read<int32_t>();
-        str.value = stream.read(valueLength).str();
+        str.value = readView(stream, valueLength);
     }
 
     auto handleLength = stream.read<int32_t>();
-    str.handle = stream.read(handleLength).str();
+    str.handle = readView(stream, handleLength);
 
     auto numArgs = stream.read<int32_t>();
     str.arguments.reserve(numArgs);
@@ -305,12 +510,12 @@ TranslatedFSStringT LSFReader::readTranslatedFSString(Stream& stream) const
     for (auto i = 0; i < numArgs; ++i) {
         TranslatedFSStringArgument arg;
         auto keyLength = stream.read<int32_t>();
-        arg.key = stream.read(keyLength).str();
-        arg.string = std::make_shared<TranslatedFSStringT>(readTranslatedFSString(stream));
+        arg.key = readView(stream, keyLength);
+        arg.string = std::make_shared<TranslatedFSStringT>(readTranslatedFSString(format, stream));
 
         auto valueLength = stream.read<int32_t>();
-        arg.value = stream.read(valueLength).str();
-        str.arguments[i] = arg;
+        arg.value = readView(stream, valueLength);
+        str.arguments.emplace_back(std::move(arg));
     }
 
     return str;
@@ -341,8 +546,11 @@ AttributeValue LSFReader::readMatrix(const NodeAttribute& attr, Stream& stream)
     return val;
 }
 
-NodeAttribute LSFReader::readAttribute(AttributeType type, Stream& reader, uint32_t length) const
+NodeAttribute LSFReader::readAttribute(const LSFValueFormat& format, AttributeType type, Stream& reader,
+                                       uint32_t length)
 {
+    const auto& gameVersion = format.gameVersion;
+
     NodeAttribute attr(type);
     TranslatedStringT str;
 
@@ -356,12 +564,16 @@ NodeAttribute LSFReader::readAttribute(AttributeType type, Stream& reader, uint3
     case WString:
     case LSWString:
     case ScratchBuffer:
-        attr.setValue(readString(reader, length));
+        if (format.zeroCopy) {
+            attr.setValue(readString(reader, length));
+        } else {
+            attr.setValue(std::string(readString(reader, length)));
+        }
         break;
     case TranslatedString:
-        if (m_version >= LSFVersion::BG3 || (m_gameVersion.major > 4 ||
-            (m_gameVersion.major == 4 && m_gameVersion.revision > 0) ||
-            (m_gameVersion.major == 4 && m_gameVersion.revision == 0 && m_gameVersion.build >= 0x1a))) {
+        if (format.version >= LSFVersion::BG3 || (gameVersion.major > 4 ||
+            (gameVersion.major == 4 && gameVersion.revision > 0) ||
+            (gameVersion.major == 4 && gameVersion.revision == 0 && gameVersion.build >= 0x1a))) {
             str.version = reader.read<uint16_t>();
         } else {
             str.version = 0;
@@ -374,7 +586,7 @@ NodeAttribute LSFReader::readAttribute(AttributeType type, Stream& reader, uint3
         attr.setValue(str);
         break;
     case TranslatedFSString:
-        attr.setValue(readTranslatedFSString(reader));
+        attr.setValue(readTranslatedFSString(format, reader));
         break;
     case IVec2:
     case IVec3:
@@ -447,7 +659,7 @@ NodeAttribute LSFReader::readAttribute(AttributeType type, Stream& reader)
         attr.setValue(reader.read<double>());
         break;
     case Bool:
-        attr.setValue(reader.read<uint8_t>());
+        attr.setValue(reader.read<uint8_t>() != 0);
         break;
     case Uuid:
         attr.setValue(readUUID(reader));
@@ -463,13 +675,19 @@ void LSFReader::readNode(const LSFNodeInfo& defn, LSNode& node, Stream& attribut
 {
     node.name = m_names[defn.nameIndex][defn.nameOffset];
 
+    if (defn.keyNameIndex != -1) {
+        node.keyAttribute = m_names[defn.keyNameIndex][defn.keyNameOffset];
+    }
+
     if (defn.firstAttributeIndex != -1) {
+        auto format = valueFormat();
         auto attribute = m_attributes[defn.firstAttributeIndex];
         while (true) {
             m_values.seek(attribute.dataOffset, SeekMode::Begin);
-            auto value = readAttribute(static_cast<AttributeType>(attribute.typeId), attributeReader, attribute.length);
+            auto value = readAttribute(format, static_cast<AttributeType>(attribute.typeId), attributeReader,
+                                       attribute.length);
 
-            node.attributes[m_names[attribute.nameIndex][attribute.nameOffset]] = value;
+            node.attributes[std::string(m_names[attribute.nameIndex][attribute.nameOffset])] = std::move(value);
 
             if (attribute.nextAttributeIndex == -1) {
                 break;
@@ -490,14 +708,12 @@ void LSFReader::readRegions(const Resource::Ptr& resource)
         if (defn.parentIndex == -1) {
             auto region = std::make_shared<Region>();
             readNode(defn, *region, attrReader);
-            region->keyAttribute = defn.keyAttribute;
             m_nodeInstances.emplace_back(region);
             region->regionName = region->name;
             resource->regions[region->regionName] = std::move(region);
         } else {
             auto node = std::make_shared<LSNode>();
             readNode(defn, *node, attrReader);
-            node->keyAttribute = defn.keyAttribute;
             node->parent = m_nodeInstances[defn.parentIndex];
             m_nodeInstances.emplace_back(node);
             m_nodeInstances[defn.parentIndex]->children[node->name].emplace_back(node);
@@ -505,34 +721,64 @@ void LSFReader::readRegions(const Resource::Ptr& resource)
     }
 }
 
-std::string LSFReader::readString(Stream& stream, uint32_t length) const
+std::string_view LSFReader::readString(Stream& stream, uint32_t length)
 {
-    auto s = stream.read(length).str();
+    auto s = readView(stream, length);
     if (!s.empty() && s.back() == '\0') {
-        s.pop_back();
+        s.remove_suffix(1);
     }
 
     return s;
 }
 
-Stream LSFReader::decompress(uint32_t sizeOnDisk, uint32_t uncompressedSize, const std::string& debugDumpTo,
-                             bool allowChunked)
+LSFReader::Section LSFReader::locate(uint32_t sizeOnDisk, uint32_t uncompressedSize, const char* name,
+                                     bool allowChunked)
 {
+    Section section{
+        .name = name,
+        .offset = m_stream.tell(),
+        .sizeOnDisk = 0,
+        .uncompressedSize = uncompressedSize,
+        .compressed = false,
+        .chunked = m_version >= LSFVersion::CHUNKED_COMPRESS && allowChunked
+    };
+
     if (sizeOnDisk == 0 && uncompressedSize != 0) {
-        auto stream = m_stream.read(uncompressedSize);
-        return stream;
+        section.sizeOnDisk = uncompressedSize; // stored
+    } else if (sizeOnDisk == 0 || uncompressedSize == 0) {
+        section.uncompressedSize = 0; // no data
+    } else if (m_metadata.compressionMethod() == CompressionMethod::NONE) {
+        section.sizeOnDisk = uncompressedSize;
+    } else {
+        section.sizeOnDisk = sizeOnDisk;
+        section.compressed = true;
+    }
+
+    if (section.sizeOnDisk > m_stream.size() - section.offset) {
+        throw Exception(std::format("Section \"{}\" extends past the end of the file.", name));
     }
 
-    if (sizeOnDisk == 0 || uncompressedSize == 0) {
+    m_stream.seek(section.sizeOnDisk, SeekMode::Current);
+
+    return section;
+}
+
+Stream LSFReader::decompress(const Section& section) const
+{
+    if (section.uncompressedSize == 0) {
         return {}; // no data
     }
 
-    auto chunked = m_version >= LSFVersion::CHUNKED_COMPRESS && allowChunked;
-    auto isCompressed = m_metadata.compressionMethod() != CompressionMethod::NONE;
-    auto compressedSize = isCompressed ? sizeOnDisk : uncompressedSize;
-    auto compressedStream = m_stream.read(compressedSize);
-    auto uncompressedStream = Compression::decompress(m_metadata.compressionMethod(), compressedStream,
-        uncompressedSize, chunked);
+    auto* data = m_stream.data() + section.offset;
+
+    if (!section.compressed) {
+        return Stream::makeStream(reinterpret_cast<const char*>(data), section.uncompressedSize);
+    }
+
+    // Decompress straight out of the file buffer rather than copying the section out first
+    auto output = std::make_unique<uint8_t[]>(section.uncompressedSize);
+    auto size = Compression::decompress(m_metadata.compressionMethod(), data, section.sizeOnDisk,
+                                        {output.get(), section.uncompressedSize}, section.chunked);
 
-    return uncompressedStream;
+    return Stream::makeStream(std::move(output), size);
 }
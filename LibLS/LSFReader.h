@@ -1,6 +1,7 @@
 #pragma once
 #include "LSCommon.h"
 #include "LSFCommon.h"
+#include "LSFDocument.h"
 #include "Resource.h"
 #include "Stream.h"
 
@@ -11,16 +12,50 @@ public:
     ~LSFReader();
 
     Resource::Ptr read(const ByteBuffer& info);
+    Resource::Ptr read(const uint8_t* data, size_t size);
     Resource::Ptr read(StreamBase& stream);
 
+    // Store string attribute values as views into the decompressed values section, which the returned
+    // Resource then owns, rather than as a std::string each. Values copied out of the tree are only
+    // valid while that Resource is alive.
+    void setZeroCopy(bool enabled);
+
+    // Decompress the sections of large compressed files concurrently, decoding the node and attribute
+    // tables while the values section is still being decompressed. On by default; callers that already
+    // read many files in parallel may turn it off.
+    void setParallel(bool enabled);
+
+    // Reads the file into the flat LSFDocument form without building an LSNode tree
+    LSFDocument::Ptr readDocument(const ByteBuffer& info);
+    LSFDocument::Ptr readDocument(const uint8_t* data, size_t size);
+    LSFDocument::Ptr readDocument(StreamBase& stream);
+
+    // Decodes the value of an attribute of the given type and length at the stream position
+    static NodeAttribute readAttribute(const LSFValueFormat& format, AttributeType type, Stream& reader,
+                                       uint32_t length);
+
 private:
+    // Location of a section in the file; sections are stored back to back after the metadata
+    struct Section
+    {
+        const char* name;
+        size_t offset;
+        uint32_t sizeOnDisk;
+        uint32_t uncompressedSize;
+        bool compressed;
+        bool chunked;
+    };
+
     static AttributeValue readMatrix(const NodeAttribute& attr, Stream& stream);
-    NodeAttribute readAttribute(AttributeType type, Stream& reader, uint32_t length) const;
     static AttributeValue readVector(const NodeAttribute& attr, Stream& stream);
     static NodeAttribute readAttribute(AttributeType type, Stream& reader);
-    TranslatedFSStringT readTranslatedFSString(Stream& stream) const;
-    Stream decompress(uint32_t sizeOnDisk, uint32_t uncompressedSize, const std::string& debugDumpTo, bool allowChunked);
+    static TranslatedFSStringT readTranslatedFSString(const LSFValueFormat& format, Stream& stream);
+    Section locate(uint32_t sizeOnDisk, uint32_t uncompressedSize, const char* name, bool allowChunked);
+    Stream decompress(const Section& section) const;
     Resource::Ptr read();
+    LSFDocument::Ptr readDocument();
+    void readSections();
+    LSFValueFormat valueFormat() const;
     void readAttributesV2(Stream& stream);
     void readAttributesV3(Stream& stream);
     void readHeader();
@@ -29,14 +64,16 @@ private:
     void readNode(const LSFNodeInfo& defn, LSNode& node, Stream& attributeReader);
     void readNodes(Stream& stream, bool longNodes);
     void readRegions(const Resource::Ptr& resource);
-    std::string readString(Stream& stream, uint32_t length) const;
+    static std::string_view readString(Stream& stream, uint32_t length);
 
-    Stream m_stream, m_values;
+    Stream m_stream, m_strings, m_values;
     PackedVersion m_gameVersion;
     LSFVersion m_version;
     LSFMetadataV6 m_metadata{};
-    std::vector <std::vector< std::string>> m_names; // hash -> name chain
+    std::vector<std::vector<std::string_view>> m_names; // hash -> name chain, viewing m_strings
     std::vector<LSFNodeInfo> m_nodes;
     std::vector<LSNode::Ptr> m_nodeInstances;
     std::vector<LSFAttributeInfo> m_attributes;
+    bool m_zeroCopy{false};
+    bool m_parallel{true};
 };
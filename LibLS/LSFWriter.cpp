@@ -173,6 +173,7 @@ void LSFWriter::writeAttributeValue(const NodeAttribute& attr)
 {
     switch (attr.type()) {
     case String:
+    case Path:
     case FixedString:
     case LSString:
     case WString:
@@ -226,14 +227,20 @@ void LSFWriter::writeAttributeValue(const NodeAttribute& attr)
         m_valueStream.write(std::get<std::array<float, 4>>(attr.value()));
         break;
     case Mat2:
+        m_valueStream.write(std::get<std::array<float, 4>>(attr.value()));
+        break;
     case Mat3:
+        m_valueStream.write(std::get<std::array<float, 9>>(attr.value()));
+        break;
     case Mat3x4:
     case Mat4x3:
+        m_valueStream.write(std::get<std::array<float, 12>>(attr.value()));
+        break;
     case Mat4:
-        ASSERT(0);
+        m_valueStream.write(std::get<std::array<float, 16>>(attr.value()));
         break;
     case Bool:
-        m_valueStream.write(std::get<bool>(attr.value()));
+        m_valueStream.write<uint8_t>(std::get<bool>(attr.value()) ? 1 : 0);
         break;
     case ULongLong:
         m_valueStream.write(std::get<uint64_t>(attr.value()));
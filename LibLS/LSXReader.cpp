@@ -16,6 +16,8 @@ LSXReader::~LSXReader()
 Resource::Ptr LSXReader::read(const ByteBuffer& info)
 {
     m_resource = std::make_unique<Resource>();
+    m_region.reset();
+    m_stack.clear(); // a reader may be reused after a read that failed part way
 
     XmlWrapper xmlDoc(info);
 
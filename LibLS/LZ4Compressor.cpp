@@ -20,20 +20,18 @@ Stream LZ4Compressor::compress(const uint8_t* data, size_t size, LSCompressionLe
 
     auto compressedData = std::make_unique<uint8_t[]>(maxCompressedSize);
 
-    int result;
-    if (level == LSCompressionLevel::FAST) {
-        result = LZ4_compress_fast(reinterpret_cast<const char*>(data),
-                                   reinterpret_cast<char*>(compressedData.get()),
-                                   static_cast<int>(size),
-                                   maxCompressedSize,
-                                   1);
-    } else {
-        result = LZ4_compress_default(reinterpret_cast<const char*>(data),
-                                      reinterpret_cast<char*>(compressedData.get()),
-                                      static_cast<int>(size),
-                                      maxCompressedSize);
+    if (m_state == nullptr) {
+        m_state = std::make_unique<char[]>(LZ4_sizeofState());
     }
 
+    // Both levels use the default acceleration; the external state spares the per-call setup
+    auto result = LZ4_compress_fast_extState(m_state.get(),
+                                             reinterpret_cast<const char*>(data),
+                                             reinterpret_cast<char*>(compressedData.get()),
+                                             static_cast<int>(size),
+                                             maxCompressedSize,
+                                             1);
+
     if (result <= 0) {
         throw Exception("LZ4 compression failed");
     }
@@ -41,6 +39,12 @@ Stream LZ4Compressor::compress(const uint8_t* data, size_t size, LSCompressionLe
     return Stream({std::move(compressedData), result});
 }
 
+size_t LZ4Compressor::compress(const Compression::ChunkReader& /*reader*/, const Compression::ChunkWriter& /*writer*/,
+                               LSCompressionLevel /*level*/)
+{
+    throw Exception("LZ4 block compression cannot be streamed");
+}
+
 Stream LZ4Compressor::decompress(StreamBase& input, size_t uncompressedSize, bool chunked)
 {
     auto data = Stream::makeStream(input).detach();
@@ -56,3 +60,12 @@ Stream LZ4Compressor::decompress(const uint8_t* data, size_t size, size_t uncomp
 
     return LZ4Codec::decode(data, size, uncompressedSize, true);
 }
+
+size_t LZ4Compressor::decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, bool chunked)
+{
+    if (chunked) {
+        return LZ4FrameCompressor::decompress(data, size, output);
+    }
+
+    return LZ4Codec::decode(data, size, output);
+}
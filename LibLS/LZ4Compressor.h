@@ -9,7 +9,13 @@ public:
 
     Stream compress(StreamBase& input, LSCompressionLevel level) override;
     Stream compress(const uint8_t* data, size_t size, LSCompressionLevel level) override;
+    size_t compress(const Compression::ChunkReader& reader, const Compression::ChunkWriter& writer,
+                    LSCompressionLevel level) override;
 
     Stream decompress(StreamBase& input, size_t uncompressedSize, bool chunked = false) override;
     Stream decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool chunked = false) override;
+    size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, bool chunked = false) override;
+
+private:
+    std::unique_ptr<char[]> m_state; // block compression state, allocated on first use
 };
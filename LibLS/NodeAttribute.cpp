@@ -156,6 +156,8 @@ std::string NodeAttribute::str() const
     return std::visit([]<typename T>(const T& val) -> std::string {
         if constexpr (std::is_same_v<T, std::string>) {
             return val;
+        } else if constexpr (std::is_same_v<T, std::string_view>) {
+            return std::string(val);
         } else if constexpr (std::is_arithmetic_v<T>) {
             return std::to_string(val);
         } else if constexpr (requires { val.str(); }) {
@@ -189,6 +191,17 @@ void NodeAttribute::setValue(AttributeValue value)
     m_value = std::move(value);
 }
 
+template <typename T, std::size_t N>
+std::array<T, N> parseArray(const std::string& str)
+{
+    std::array<T, N> values{};
+    std::istringstream iss(str);
+    for (auto& value : values) {
+        iss >> value;
+    }
+    return values;
+}
+
 AttributeValue parseString(const std::string& str, AttributeType type)
 {
     switch (type) {
@@ -255,12 +268,14 @@ AttributeValue parseString(const std::string& str, AttributeType type)
         return vec4;
     }
     case Mat2:
+        return parseArray<float, 4>(str);
     case Mat3:
+        return parseArray<float, 9>(str);
     case Mat3x4:
     case Mat4x3:
+        return parseArray<float, 12>(str);
     case Mat4:
-        ASSERT(0);
-        return {};
+        return parseArray<float, 16>(str);
     case Bool:
         if (_stricmp(str.c_str(), "true") == 0 || str == "1") {
             return true;
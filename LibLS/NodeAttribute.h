@@ -110,6 +110,7 @@ using AttributeValue = std::variant <
     std::array<float, 12>, // Mat3x4, Mat4x3 (3x4)
     std::array<float, 16>, // Mat4 (4x4)
     std::string, // String, Path, LSString, WString (narrowed)
+    std::string_view, // the same, viewing the values section of a zero-copy LSF read
     FixedStringT, // FixedString
     TranslatedStringT, // TranslatedString
     TranslatedFSStringT, // TranslatedFSString
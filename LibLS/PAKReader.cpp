@@ -1,12 +1,31 @@
 #include "pch.h"
 #include "Compress.h"
+#include "CRC32.h"
 #include "Exception.h"
 #include "LZ4Compressor.h"
+#include "MD5.h"
 #include "PAKReader.h"
+#include "ProgressListener.h"
 #include "Stream.h"
+#include "ThreadPool.h"
+#include "ZSTDDictionary.h"
+
+#include <deque>
+#include <map>
+#include <set>
 
 namespace { // anonymous namespace
 
+// Maximum size of a single coalesced read and the largest hole between entries it may span
+constexpr uint64_t MAX_SCAN_RUN = 16 * 1024 * 1024;
+constexpr uint64_t MAX_SCAN_GAP = 64 * 1024;
+
+// Budget for decompressed shared blocks kept so that sibling files do not decode their block again
+constexpr size_t BLOCK_CACHE_SIZE = 64 * 1024 * 1024;
+
+// Sanity limit on the size of a stored ZSTD dictionary
+constexpr uint32_t MAX_DICTIONARY_SIZE = 16 * 1024 * 1024;
+
 template <typename TFile>
 bool readStructs(Stream& stream, std::vector<TFile>& entries, uint32_t numFiles)
 {
@@ -35,6 +54,34 @@ PackagedFileInfo createFromEntry(Package& package, const TFileEntry& entry)
     return info;
 }
 
+// Members of a shared block all point at the block; their positions within it follow file-list order
+void resolveSharedBlocks(Package& package)
+{
+    std::map<std::pair<uint32_t, uint64_t>, std::vector<PackagedFileInfo*>> blocks;
+
+    for (auto& file : package.m_files) {
+        if (file.method() != CompressionMethod::NONE && file.sizeOnDisk > 0) {
+            blocks[{file.archivePart, file.offsetInFile}].push_back(&file);
+        }
+    }
+
+    for (const auto& members : blocks | std::views::values) {
+        if (members.size() < 2) {
+            continue; // compressed on its own
+        }
+
+        uint32_t offset = 0;
+        for (auto* member : members) {
+            member->blockOffset = offset;
+            offset += member->uncompressedSize;
+        }
+
+        for (auto* member : members) {
+            member->blockSize = offset;
+        }
+    }
+}
+
 template <typename TFileEntry>
 void readCompressedFileList(PAKReader& reader, int64_t offset)
 {
@@ -72,13 +119,20 @@ void readCompressedFileList(PAKReader& reader, int64_t offset)
     }
 
     for (const auto& entry : entries) {
-        // TODO: handle archive parts, whatever they are
+        if (entry.archivePart > package.m_parts.size()) {
+            throw Exception(std::format("File \"{}\" lies in missing archive part {}.", entry.name, entry.archivePart));
+        }
+
         auto info = createFromEntry<TFileEntry>(package, entry);
         package.addFile(info);
     }
+
+    if (static_cast<uint8_t>(package.m_header.flags) & static_cast<uint8_t>(PackageFlags::SharedBlocks)) {
+        resolveSharedBlocks(package);
+    }
 }
 
-template <typename THeader, typename TFileEntry>
+template <typename THeader>
 bool readHeader(PAKReader& pakReader, int64_t offset)
 {
     auto& package = pakReader.package();
@@ -91,13 +145,12 @@ bool readHeader(PAKReader& pakReader, int64_t offset)
 
     package.m_header = header.commonHeader();
 
-    if (header.version > 10) {
-        package.m_header.dataOffset = static_cast<uint32_t>(offset) + sizeof(THeader);
-        readCompressedFileList<TFileEntry>(pakReader, package.m_header.fileListOffset);
-    } else {
+    if (header.version <= 10) {
         return false;
     }
 
+    package.m_header.dataOffset = static_cast<uint32_t>(offset) + sizeof(THeader);
+
     return true;
 }
 } // anonymous namespace
@@ -105,23 +158,39 @@ bool readHeader(PAKReader& pakReader, int64_t offset)
 PAKReader::PAKReader()
 = default;
 
+PAKReader::~PAKReader() = default;
+
 PAKReader::PAKReader(PAKReader&& rhs) noexcept
 {
-    m_package = std::move(rhs.m_package);
+    *this = std::move(rhs);
 }
 
 PAKReader& PAKReader::operator=(PAKReader&& rhs) noexcept
 {
     if (this != &rhs) {
         m_package = std::move(rhs.m_package);
+        m_index = std::move(rhs.m_index);
+        m_materialized = std::move(rhs.m_materialized);
+        m_blockCache = std::move(rhs.m_blockCache);
+        m_dictionary = std::move(rhs.m_dictionary);
+        m_useIndexCache = rhs.m_useIndexCache;
     }
 
     return *this;
 }
 
-bool PAKReader::read(const char* filename)
+void PAKReader::setIndexCache(bool enabled)
 {
-    m_package.load(filename);
+    m_useIndexCache = enabled;
+}
+
+bool PAKReader::read(const char* filename, bool memoryMapped)
+{
+    // A reader may be reused; nothing decoded for the previous package applies to the next
+    m_blockCache.reset();
+    m_dictionary.reset();
+    m_index.close();
+    m_package.load(filename, memoryMapped);
     m_package.seek(-4, SeekMode::End);
 
     auto signature = m_package.read<uint32_t>();
@@ -143,7 +212,24 @@ bool PAKReader::read(const char* filename)
             throw Exception("Unsupported PAK version.");
         }
 
-        readHeader<LSPKHeader16, FileEntry18>(*this, 4);
+        if (!readHeader<LSPKHeader16>(*this, 4)) {
+            return true;
+        }
+
+        m_package.initParts();
+
+        if (static_cast<uint8_t>(m_package.m_header.flags) & static_cast<uint8_t>(PackageFlags::SharedBlocks)) {
+            m_blockCache = std::make_unique<BlockCache>(BLOCK_CACHE_SIZE);
+        }
+
+        if (static_cast<uint8_t>(m_package.m_header.flags) & static_cast<uint8_t>(PackageFlags::Dictionary)) {
+            readDictionary();
+        }
+
+        if (!openIndex()) {
+            readCompressedFileList<FileEntry18>(*this, m_package.m_header.fileListOffset);
+            saveIndex();
+        }
 
         return true;
     }
@@ -153,20 +239,271 @@ bool PAKReader::read(const char* filename)
 
 void PAKReader::close()
 {
+    m_blockCache.reset();
+    m_dictionary.reset();
+    m_index.close();
     m_package.reset();
 }
 
-bool PAKReader::explode(const char* path)
+bool PAKReader::openIndex()
 {
-    for (auto& files = m_package.m_files; const auto& fileInfo : files) {
-        if (!extractFile(fileInfo, path)) {
+    if (!m_useIndexCache) {
+        return false;
+    }
+
+    try {
+        auto key = PackageIndex::keyFor(m_package.m_filename, m_package.m_header);
+        if (!m_index.open(PackageIndex::cachePath(m_package.m_filename), key)) {
             return false;
         }
+    } catch (const std::exception&) {
+        return false;
     }
 
+    m_materialized = std::make_unique<std::once_flag>();
+
     return true;
 }
 
+void PAKReader::saveIndex() const
+{
+    if (!m_useIndexCache) {
+        return;
+    }
+
+    try {
+        auto key = PackageIndex::keyFor(m_package.m_filename, m_package.m_header);
+        PackageIndex::save(PackageIndex::cachePath(m_package.m_filename), key, m_package.m_files);
+    } catch (const std::exception&) {
+        // The cache is an optimization only
+    }
+}
+
+void PAKReader::ensureFiles() const
+{
+    if (!m_index.isOpen()) {
+        return;
+    }
+
+    std::call_once(*m_materialized, [this] {
+        auto files = m_index.files();
+        m_package.m_files.reserve(files.size());
+
+        for (const auto& file : files) {
+            m_package.addFile(file);
+        }
+    });
+}
+
+PackagedFileInfo PAKReader::lookup(const std::string& name) const
+{
+    if (m_index.isOpen()) {
+        PackagedFileInfo info;
+        if (!m_index.find(name, info)) {
+            throw std::out_of_range("File not found.");
+        }
+
+        return info;
+    }
+
+    return (*this)[name];
+}
+
+bool PAKReader::explode(const char* path, IFileProgressListener* listener, uint32_t threads)
+{
+    ensureFiles();
+
+    const auto& files = m_package.m_files;
+    const std::filesystem::path root(path);
+
+    if (listener) {
+        listener->onStart(files.size());
+    }
+
+    // Create the directory tree up front so workers never contend on it
+    std::set<std::filesystem::path> directories;
+    for (const auto& file : files) {
+        directories.insert((root / file.name).parent_path());
+    }
+
+    for (const auto& directory : directories) {
+        create_directories(directory);
+    }
+
+    ThreadPool pool(threads);
+
+    // Bound the number of decompressed files held in memory at once
+    const size_t maxInFlight = pool.size() * 2;
+
+    std::deque<std::pair<size_t, std::future<bool>>> pending;
+    auto result = true;
+    auto cancelled = false;
+
+    auto retire = [&] {
+        auto& [index, future] = pending.front();
+        result = future.get() && result;
+        if (listener) {
+            listener->onFile(index, files[index].name);
+        }
+        pending.pop_front();
+    };
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (listener && listener->isCancelled()) {
+            cancelled = true;
+            break;
+        }
+
+        if (pending.size() >= maxInFlight) {
+            retire();
+        }
+
+        pending.emplace_back(i, pool.submit([this, &root, &file = files[i]] {
+            return extractFile(file, root);
+        }));
+    }
+
+    while (!pending.empty()) {
+        retire();
+    }
+
+    if (listener) {
+        if (cancelled) {
+            listener->onCancel();
+        } else {
+            listener->onFinished(files.size());
+        }
+    }
+
+    return result;
+}
+
+PackageVerifyResult PAKReader::verify(IFileProgressListener* listener, uint32_t threads) const
+{
+    ensureFiles();
+
+    // The archive MD5 covers the contents of every file in name order, as PAKWriter accumulates it
+    std::vector<const PackagedFileInfo*> files;
+    files.reserve(m_package.m_files.size());
+    for (const auto& file : m_package.m_files) {
+        files.push_back(&file);
+    }
+
+    std::ranges::stable_sort(files, [](const PackagedFileInfo* a, const PackagedFileInfo* b) {
+        return std::ranges::lexicographical_compare(a->name, b->name);
+    });
+
+    const auto& header = m_package.m_header;
+    const auto hashed = std::ranges::any_of(header.md5, [](uint8_t b) { return b != 0; });
+
+    struct CheckedFile
+    {
+        PackagedFileData contents;
+        std::string error;
+    };
+
+    auto check = [this, &header](const PackagedFileInfo& file) {
+        CheckedFile checked;
+
+        if (file.archivePart == 0 && file.offsetInFile + file.sizeOnDisk > header.fileListOffset) {
+            checked.error = "entry extends into the file list";
+            return checked;
+        }
+
+        try {
+            checked.contents = readFileData(file);
+        } catch (const std::exception& e) {
+            checked.error = e.what();
+            return checked;
+        }
+
+        if (checked.contents.size() != file.size()) {
+            checked.error = std::format("decoded {} bytes, expected {}", checked.contents.size(), file.size());
+        } else if (file.crc != 0) {
+            auto crc = CRC32::compute(checked.contents.data(), checked.contents.size());
+            if (crc != file.crc) {
+                checked.error = std::format("CRC32 {:08X} does not match {:08X}", crc, file.crc);
+            }
+        }
+
+        return checked;
+    };
+
+    PackageVerifyResult result;
+    MD5 md5;
+
+    if (listener) {
+        listener->onStart(files.size());
+    }
+
+    ThreadPool pool(threads);
+
+    // Checked contents wait here until their turn in the hash, so keep the window short
+    const size_t maxInFlight = pool.size() * 2;
+
+    std::deque<std::pair<size_t, std::future<CheckedFile>>> pending;
+
+    auto retire = [&] {
+        auto& [index, future] = pending.front();
+        const auto& file = *files[index];
+        auto checked = future.get();
+
+        if (checked.error.empty()) {
+            if (hashed) {
+                md5.update(checked.contents.data(), checked.contents.size());
+            }
+        } else {
+            result.errors.push_back({file.name, file.archivePart, file.offsetInFile, std::move(checked.error)});
+        }
+
+        ++result.files;
+
+        if (listener) {
+            listener->onFile(index, file.name);
+        }
+
+        pending.pop_front();
+    };
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (listener && listener->isCancelled()) {
+            result.cancelled = true;
+            break;
+        }
+
+        if (pending.size() >= maxInFlight) {
+            retire();
+        }
+
+        pending.emplace_back(i, pool.submit([&check, &file = *files[i]] {
+            return check(file);
+        }));
+    }
+
+    while (!pending.empty()) {
+        retire();
+    }
+
+    // A file that could not be read leaves the digest incomplete, so it is only compared when all were
+    if (hashed && !result.cancelled && result.errors.empty()) {
+        uint8_t digest[16];
+        md5.finalize(digest);
+
+        result.hashChecked = true;
+        result.hashMatches = memcmp(digest, header.md5, sizeof(digest)) == 0;
+    }
+
+    if (listener) {
+        if (result.cancelled) {
+            listener->onCancel();
+        } else {
+            listener->onFinished(result.files);
+        }
+    }
+
+    return result;
+}
+
 const std::string& PAKReader::filename() const
 {
     return m_package.m_filename;
@@ -177,13 +514,22 @@ Package& PAKReader::package()
     return m_package;
 }
 
+const Package& PAKReader::package() const
+{
+    return m_package;
+}
+
 const std::vector<PackagedFileInfo>& PAKReader::files() const
 {
+    ensureFiles();
+
     return m_package.m_files;
 }
 
 const PackagedFileInfo& PAKReader::operator[](const std::string& name) const
 {
+    ensureFiles();
+
     auto it = m_package.m_filemap.find(name);
     if (it != m_package.m_filemap.end()) {
         return m_package.m_files[it->second];
@@ -192,8 +538,22 @@ const PackagedFileInfo& PAKReader::operator[](const std::string& name) const
     throw std::out_of_range("File not found.");
 }
 
+const PackagedFileInfo* PAKReader::find(const std::string& name) const
+{
+    ensureFiles();
+
+    auto it = m_package.m_filemap.find(name);
+    if (it != m_package.m_filemap.end()) {
+        return &m_package.m_files[it->second];
+    }
+
+    return nullptr;
+}
+
 void PAKReader::sortFiles()
 {
+    ensureFiles();
+
     std::ranges::sort(m_package.m_files,
                       [](const PackagedFileInfo& a, const PackagedFileInfo& b) {
                           return a.name < b.name;
@@ -206,49 +566,276 @@ void PAKReader::sortFiles()
     }
 }
 
-ByteBuffer PAKReader::readFile(const std::string& name)
+ByteBuffer PAKReader::readFile(const std::string& name) const
 {
-    const auto& file = (*this)[name];
+    return readFile(lookup(name));
+}
 
-    m_package.seek(static_cast<int64_t>(file.offsetInFile), SeekMode::Begin);
+ByteBuffer PAKReader::readFile(const PackagedFileInfo& file) const
+{
+    return readFileData(file).detach();
+}
 
-    auto fileData = std::make_unique<uint8_t[]>(file.sizeOnDisk);
-    m_package.read(fileData.get(), file.sizeOnDisk);
+PackagedFileData PAKReader::readFileData(const std::string& name) const
+{
+    return readFileData(lookup(name));
+}
 
+PackagedFileData PAKReader::readFileData(const PackagedFileInfo& file) const
+{
     if (file.sizeOnDisk == 0) {
-        return {nullptr, 0};
+        return {};
+    }
+
+    if (file.isBlockMember()) {
+        return readBlockFile(file);
+    }
+
+    if (m_package.isMapped()) {
+        // Stored entries are served in place; compressed entries decompress straight from the mapped pages
+        return decodeFile(file, m_package.view(file.archivePart, file.offsetInFile, file.sizeOnDisk));
+    }
+
+    auto contents = std::make_unique<uint8_t[]>(file.size());
+    auto size = readFile(file, {contents.get(), file.size()});
+
+    return PackagedFileData({std::move(contents), size});
+}
+
+size_t PAKReader::readFile(const PackagedFileInfo& file, std::span<uint8_t> output) const
+{
+    if (output.size() < file.size()) {
+        throw Exception(std::format("Buffer too small to read \"{}\".", file.name));
+    }
+
+    if (file.sizeOnDisk == 0) {
+        return 0;
+    }
+
+    if (file.isBlockMember()) {
+        auto block = sharedBlock(file, nullptr);
+        memcpy(output.data(), block->first.get() + file.blockOffset, file.uncompressedSize);
+        return file.uncompressedSize;
+    }
+
+    if (file.method() == CompressionMethod::NONE) {
+        m_package.readAt(file.archivePart, file.offsetInFile, output.data(), file.sizeOnDisk);
+        return file.sizeOnDisk;
+    }
+
+    const uint8_t* compressed;
+    UInt8Ptr buffer;
+
+    if (m_package.isMapped()) {
+        compressed = m_package.view(file.archivePart, file.offsetInFile, file.sizeOnDisk);
+    } else {
+        buffer = std::make_unique<uint8_t[]>(file.sizeOnDisk);
+        m_package.readAt(file.archivePart, file.offsetInFile, buffer.get(), file.sizeOnDisk);
+        compressed = buffer.get();
+    }
+
+    return decompress(file.method(), compressed, file.sizeOnDisk, output.first(file.size()));
+}
+
+PackagedFileData PAKReader::decodeFile(const PackagedFileInfo& file, const uint8_t* data) const
+{
+    if (file.sizeOnDisk == 0) {
+        return {};
+    }
+
+    if (file.method() == CompressionMethod::NONE) {
+        return {data, file.size()};
+    }
+
+    auto contents = std::make_unique<uint8_t[]>(file.uncompressedSize);
+    auto size = decompress(file.method(), data, file.sizeOnDisk, {contents.get(), file.uncompressedSize});
+
+    return PackagedFileData({std::move(contents), size});
+}
+
+size_t PAKReader::decompress(CompressionMethod method, const uint8_t* data, size_t size,
+                             std::span<uint8_t> output) const
+{
+    if (m_dictionary && method == CompressionMethod::ZSTD) {
+        return Compression::decompress(data, size, output, *m_dictionary);
+    }
+
+    return Compression::decompress(method, data, size, output);
+}
+
+void PAKReader::readDictionary()
+{
+    const auto offset = m_package.m_header.dataOffset;
+
+    uint32_t size;
+    m_package.readAt(0, offset, &size, sizeof(size));
+
+    if (size == 0 || size > MAX_DICTIONARY_SIZE) {
+        throw Exception(std::format("Invalid compression dictionary size: {}", size));
+    }
+
+    auto contents = std::make_unique<uint8_t[]>(size);
+    m_package.readAt(0, offset + sizeof(size), contents.get(), size);
+
+    m_dictionary = std::make_unique<ZSTDDictionary>(ByteBuffer{std::move(contents), size});
+}
+
+size_t PAKReader::scanFiles(const FileFilter& filter, const FileVisitor& visitor) const
+{
+    ensureFiles();
+
+    std::vector<const PackagedFileInfo*> entries;
+    for (const auto& file : m_package.m_files) {
+        if (!filter || filter(file)) {
+            entries.push_back(&file);
+        }
     }
 
-    if (file.method() != CompressionMethod::NONE) {
-        auto decompressed = Compression::decompress(file.method(), fileData.get(), file.sizeOnDisk,
-                                                    file.uncompressedSize);
-        return decompressed.detach();
+    std::ranges::sort(entries, [](const PackagedFileInfo* a, const PackagedFileInfo* b) {
+        return std::tie(a->archivePart, a->offsetInFile) < std::tie(b->archivePart, b->offsetInFile);
+    });
+
+    std::vector<uint8_t> buffer;
+    size_t visited = 0;
+
+    for (size_t first = 0; first < entries.size();) {
+        // Extend the run while the next entry starts near the end of the current one
+        const auto part = entries[first]->archivePart;
+        const auto begin = entries[first]->offsetInFile;
+        auto end = begin + entries[first]->sizeOnDisk;
+        auto last = first + 1;
+
+        for (; last < entries.size(); ++last) {
+            const auto* next = entries[last];
+            if (next->archivePart != part || next->offsetInFile > end + MAX_SCAN_GAP) {
+                break;
+            }
+
+            auto nextEnd = std::max(end, next->offsetInFile + next->sizeOnDisk);
+            if (nextEnd - begin > MAX_SCAN_RUN) {
+                break;
+            }
+
+            end = nextEnd;
+        }
+
+        const uint8_t* run = nullptr;
+        if (end > begin) {
+            if (m_package.isMapped()) {
+                run = m_package.view(part, begin, end - begin);
+            } else {
+                buffer.resize(end - begin);
+                m_package.readAt(part, begin, buffer.data(), buffer.size());
+                run = buffer.data();
+            }
+        }
+
+        for (; first < last; ++first) {
+            const auto& file = *entries[first];
+            auto* data = run + (file.offsetInFile - begin);
+            auto contents = file.isBlockMember() ? readBlockFile(file, data) : decodeFile(file, data);
+            if (!visitor(visited++, file, contents)) {
+                return visited;
+            }
+        }
     }
 
-    return {std::move(fileData), file.size()};
+    return visited;
+}
+
+PackagedFileData PAKReader::readBlockFile(const PackagedFileInfo& file, const uint8_t* compressed) const
+{
+    auto block = sharedBlock(file, compressed);
+
+    // Copied out so the block may be evicted while the caller still holds the contents
+    auto contents = std::make_unique<uint8_t[]>(file.uncompressedSize);
+    memcpy(contents.get(), block->first.get() + file.blockOffset, file.uncompressedSize);
+
+    return PackagedFileData({std::move(contents), file.uncompressedSize});
 }
 
-bool PAKReader::extractFile(const PackagedFileInfo& file, const char* path)
+PAKReader::BlockCache::ValuePtr PAKReader::sharedBlock(const PackagedFileInfo& file, const uint8_t* compressed) const
 {
-    auto [fileData, fileSize] = readFile(file.name);
+    if (m_blockCache == nullptr) {
+        throw Exception("Package has no shared blocks.");
+    }
+
+    auto key = static_cast<uint64_t>(file.archivePart) << 48 | file.offsetInFile;
+
+    auto block = m_blockCache->getOrLoad(key, [&] {
+        UInt8Ptr buffer;
+
+        if (compressed == nullptr) {
+            if (m_package.isMapped()) {
+                compressed = m_package.view(file.archivePart, file.offsetInFile, file.sizeOnDisk);
+            } else {
+                buffer = std::make_unique<uint8_t[]>(file.sizeOnDisk);
+                m_package.readAt(file.archivePart, file.offsetInFile, buffer.get(), file.sizeOnDisk);
+                compressed = buffer.get();
+            }
+        }
 
-    std::filesystem::path outputPath = std::filesystem::path(path) / file.name;
-    create_directories(outputPath.parent_path()); // Ensure parent directories exist
+        auto decompressed = std::make_shared<ByteBuffer>(std::make_unique<uint8_t[]>(file.blockSize), 0);
+        decompressed->second = decompress(file.method(), compressed, file.sizeOnDisk,
+                                          {decompressed->first.get(), file.blockSize});
+
+        return std::make_pair(BlockCache::ValuePtr(decompressed), decompressed->second);
+    });
+
+    if (file.blockOffset > block->second || file.uncompressedSize > block->second - file.blockOffset) {
+        throw Exception(std::format("File \"{}\" lies outside of its shared block.", file.name));
+    }
+
+    return block;
+}
+
+size_t PAKReader::countFiles(const FileFilter& filter) const
+{
+    ensureFiles();
+
+    if (!filter) {
+        return m_package.m_files.size();
+    }
+
+    return std::ranges::count_if(m_package.m_files, filter);
+}
+
+PAKReader::FileFilter PAKReader::extensionFilter(std::initializer_list<std::string_view> extensions)
+{
+    std::vector<std::string> exts(extensions.begin(), extensions.end());
+
+    return [exts = std::move(exts)](const PackagedFileInfo& file) {
+        return std::ranges::any_of(exts, [&](const std::string& ext) {
+            return file.name.size() >= ext.size()
+                && _strnicmp(file.name.c_str() + file.name.size() - ext.size(), ext.c_str(), ext.size()) == 0;
+        });
+    };
+}
+
+bool PAKReader::extractFile(const PackagedFileInfo& file, const std::filesystem::path& root) const
+{
+    auto fileData = readFileData(file);
+
+    auto outputPath = root / file.name;
 
     FileStream outFile;
     outFile.open(outputPath.string().c_str(), "wb");
-    outFile.write(fileData.get(), fileSize);
+    outFile.write(fileData.data(), fileData.size());
 
     return true;
 }
 
-bool Package::load(const char* filename)
+bool Package::load(const char* filename, bool memoryMapped)
 {
     reset();
 
     m_filename = filename;
     m_file.open(m_filename.c_str(), "rb");
 
+    if (memoryMapped) {
+        m_mapping.open(m_filename.c_str());
+    }
+
     return true;
 }
 
@@ -260,16 +847,42 @@ void Package::seek(int64_t offset, SeekMode mode)
 void Package::reset()
 {
     m_file.close();
+    m_mapping.close();
 
+    m_parts.clear();
     m_files.clear();
     m_filemap.clear();
 }
 
+void Package::initParts()
+{
+    m_parts.clear();
+
+    // Secondary parts are only opened once a file stored in them is read
+    for (uint32_t part = 1; part < m_header.numParts; ++part) {
+        m_parts.emplace_back(std::make_unique<PackagePart>());
+    }
+}
+
 void Package::read(void* buffer, std::size_t size)
 {
     m_file.read(static_cast<char*>(buffer), size);
 }
 
+void Package::readAt(uint32_t part, uint64_t offset, void* buffer, std::size_t size) const
+{
+    if (isMapped()) {
+        memcpy(buffer, view(part, offset, size), size);
+        return;
+    }
+
+    const auto& file = part == 0 ? m_file : openPart(part).file;
+
+    if (file.readAt(offset, buffer, size) != size) {
+        throw Exception("Unexpected end of package file.");
+    }
+}
+
 Package::Package()
 = default;
 
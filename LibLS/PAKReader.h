@@ -1,12 +1,42 @@
 #pragma once
 
+#include "LRUCache.h"
 #include "Package.h"
+#include "PackageIndex.h"
+
+#include <mutex>
+
+class IFileProgressListener;
+class ZSTDDictionary;
+
+// An entry that failed verification, located by its position in the archive
+struct PackageVerifyError
+{
+    std::string name;
+    uint32_t archivePart;
+    uint64_t offset;
+    std::string message;
+};
+
+struct PackageVerifyResult
+{
+    size_t files{0}; // entries checked
+    std::vector<PackageVerifyError> errors;
+    bool hashChecked{false}; // the package carries an archive MD5 and every entry was read
+    bool hashMatches{false};
+    bool cancelled{false};
+
+    bool ok() const
+    {
+        return !cancelled && errors.empty() && (!hashChecked || hashMatches);
+    }
+};
 
 class PAKReader final
 {
 public:
     PAKReader();
-    ~PAKReader() = default;
+    ~PAKReader();
 
     PAKReader(PAKReader&&) noexcept;
     PAKReader& operator=(PAKReader&&) noexcept;
@@ -14,21 +44,76 @@ public:
     PAKReader(const PAKReader&) = delete;
     PAKReader& operator=(const PAKReader&) = delete;
 
-    bool explode(const char* path);
-    bool read(const char* filename);
-    ByteBuffer readFile(const std::string& name);
+    // Extracts every file beneath path; a thread count of zero uses one worker per hardware thread.
+    // Progress is reported in archive order from the calling thread.
+    bool explode(const char* path, IFileProgressListener* listener = nullptr, uint32_t threads = 0);
+    bool read(const char* filename, bool memoryMapped = false);
+
+    // Decompresses every entry on a pool of workers and checks its size, its CRC32 where the entry
+    // has one, and the archive MD5 of packages built with hashing. Progress is reported in name order.
+    PackageVerifyResult verify(IFileProgressListener* listener = nullptr, uint32_t threads = 0) const;
+
+    // Cache the file list in a memory-mapped index under %LOCALAPPDATA% so that reopening the
+    // same archive skips decoding it; the list is then only materialized when it is first enumerated.
+    void setIndexCache(bool enabled);
+
+    // File reads are positional and do not disturb the package stream;
+    // they may be issued concurrently from multiple threads once the archive has been read.
+    ByteBuffer readFile(const std::string& name) const;
+    ByteBuffer readFile(const PackagedFileInfo& file) const;
+    PackagedFileData readFileData(const std::string& name) const;
+    PackagedFileData readFileData(const PackagedFileInfo& file) const;
+
+    // Reads into a caller-provided buffer of at least file.size() bytes, so one buffer
+    // can be reused across entries; returns the number of bytes written.
+    size_t readFile(const PackagedFileInfo& file, std::span<uint8_t> output) const;
+
+    using FileFilter = std::function<bool(const PackagedFileInfo& file)>;
+
+    // Return false from the visitor to stop the scan.
+    // The contents passed to the visitor are only valid for the duration of the call.
+    using FileVisitor = std::function<bool(size_t index, const PackagedFileInfo& file,
+                                           const PackagedFileData& contents)>;
+
+    // Visits the files accepted by filter in physical archive order, coalescing neighboring entries into large reads.
+    // Returns the number of files visited.
+    size_t scanFiles(const FileFilter& filter, const FileVisitor& visitor) const;
+    size_t countFiles(const FileFilter& filter) const;
+
+    // Accepts files whose name ends with one of the given extensions, ignoring case
+    static FileFilter extensionFilter(std::initializer_list<std::string_view> extensions);
 
     const PackagedFileInfo& operator[](const std::string& name) const;
+    const PackagedFileInfo* find(const std::string& name) const;
 
     void sortFiles();
     const std::vector<PackagedFileInfo>& files() const;
 
     Package& package();
+    const Package& package() const;
     void close();
     const std::string& filename() const;
 
 private:
-    bool extractFile(const PackagedFileInfo& file, const char* path);
+    bool extractFile(const PackagedFileInfo& file, const std::filesystem::path& root) const;
+    bool openIndex();
+    void saveIndex() const;
+    void ensureFiles() const;
+    PackagedFileInfo lookup(const std::string& name) const;
+    PackagedFileData readBlockFile(const PackagedFileInfo& file, const uint8_t* compressed = nullptr) const;
+    PackagedFileData decodeFile(const PackagedFileInfo& file, const uint8_t* data) const;
+    size_t decompress(CompressionMethod method, const uint8_t* data, size_t size, std::span<uint8_t> output) const;
+    void readDictionary();
+
+    // Decompressed shared blocks, keyed by archive part and offset
+    using BlockCache = LRUCache<uint64_t, ByteBuffer>;
+
+    BlockCache::ValuePtr sharedBlock(const PackagedFileInfo& file, const uint8_t* compressed) const;
 
-    Package m_package{};
+    mutable Package m_package{}; // file list may be materialized lazily from m_index
+    PackageIndex m_index;
+    std::unique_ptr<std::once_flag> m_materialized;
+    std::unique_ptr<BlockCache> m_blockCache;
+    std::unique_ptr<ZSTDDictionary> m_dictionary; // shared by the ZSTD entries of dictionary-compressed archives
+    bool m_useIndexCache{false};
 };
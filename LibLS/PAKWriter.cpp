@@ -2,31 +2,205 @@
 
 #include "Compress.h"
 #include "CRC32.h"
+#include "Exception.h"
 #include "LZ4Codec.h"
 #include "MD5.h"
 #include "PAKWriter.h"
 #include "Stream.h"
+#include "ThreadPool.h"
+
+#include <deque>
+#include <lz4hc.h>
 
 #include <filesystem>
 namespace fs = std::filesystem;
 
+namespace { // anonymous namespace
+
+constexpr size_t STREAM_CHUNK_SIZE = 1024 * 1024;
+constexpr size_t SHARED_BLOCK_SIZE = 1024 * 1024; // decompressed size at which a shared block is written
+constexpr size_t BLOCK_MEMBER_LIMIT = 64 * 1024; // larger files are compressed on their own
+
+// ZSTD's recommended dictionary size, trained from roughly a hundred times as much sample data
+constexpr size_t DICTIONARY_SIZE = 112 * 1024;
+constexpr size_t DICTIONARY_SAMPLE_BUDGET = 100 * DICTIONARY_SIZE;
+constexpr uintmax_t DICTIONARY_SAMPLE_LIMIT = 128 * 1024; // larger files gain little from a dictionary
+
+// Adaptive builds estimate each file's ratio from its leading bytes. A file is stored unless
+// compression saves at least ADAPTIVE_MIN_GAIN of it, and ZSTD, being slower to decode, is only
+// chosen when it beats LZ4 by ADAPTIVE_ZSTD_GAIN.
+constexpr size_t ADAPTIVE_SAMPLE_SIZE = 64 * 1024;
+constexpr double ADAPTIVE_MIN_GAIN = 0.10;
+constexpr double ADAPTIVE_ZSTD_GAIN = 0.10;
+
+// File lists at least this long are filled on the worker threads
+constexpr size_t FILE_LIST_PARALLEL_MIN = 16 * 1024;
+
+void hashFile(MD5& md5, const std::string& filename)
+{
+    FileStream input;
+    input.open(filename.c_str(), "rb");
+
+    auto buffer = std::make_unique<uint8_t[]>(STREAM_CHUNK_SIZE);
+    for (size_t read; (read = input.read(reinterpret_cast<char*>(buffer.get()), STREAM_CHUNK_SIZE)) > 0;) {
+        md5.update(buffer.get(), read);
+    }
+}
+
+std::string hexDigest(MD5& md5)
+{
+    uint8_t digest[16];
+    md5.finalize(digest);
+
+    std::string hex;
+    for (auto b : digest) {
+        hex += std::format("{:02x}", b);
+    }
+
+    return hex;
+}
+
+std::string contentDigest(const uint8_t* data, size_t size)
+{
+    MD5 md5;
+    md5.update(data, size);
+    return hexDigest(md5);
+}
+
+std::string contentDigest(const std::string& filename)
+{
+    MD5 md5;
+    hashFile(md5, filename);
+    return hexDigest(md5);
+}
+
+const char* methodName(CompressionMethod method)
+{
+    switch (method) {
+    case CompressionMethod::ZLIB:
+        return "ZLib";
+    case CompressionMethod::LZ4:
+        return "LZ4";
+    case CompressionMethod::ZSTD:
+        return "ZSTD";
+    default:
+        return "Stored";
+    }
+}
+
+PackageManifestEntry statFile(const std::string& filename)
+{
+    PackageManifestEntry entry;
+    entry.size = fs::file_size(filename);
+    entry.mtime = fs::last_write_time(filename).time_since_epoch().count();
+    return entry;
+}
+
+} // anonymous namespace
+
+PackageBuildSummary::Totals& PackageBuildSummary::operator[](CompressionMethod method)
+{
+    return methods.at(static_cast<size_t>(method));
+}
+
+const PackageBuildSummary::Totals& PackageBuildSummary::operator[](CompressionMethod method) const
+{
+    return methods.at(static_cast<size_t>(method));
+}
+
+std::string PackageBuildSummary::format() const
+{
+    constexpr auto MB = 1024.0 * 1024.0;
+
+    std::string summary;
+
+    for (auto method : {CompressionMethod::NONE, CompressionMethod::LZ4, CompressionMethod::ZSTD,
+                        CompressionMethod::ZLIB}) {
+        const auto& totals = (*this)[method];
+        if (totals.files == 0) {
+            continue;
+        }
+
+        summary += std::format("{}: {} files, {:.1f} MB", methodName(method), totals.files, totals.size / MB);
+        if (method != CompressionMethod::NONE) {
+            summary += std::format(" -> {:.1f} MB", totals.sizeOnDisk / MB);
+        }
+
+        summary += "\n";
+    }
+
+    if (lowGain > 0) {
+        summary += std::format("{} files stored because compression gained too little.\n", lowGain);
+    }
+
+    if (reused > 0) {
+        summary += std::format("{} files reused from the previous package.\n", reused);
+    }
+
+    if (!storedTooLarge.empty()) {
+        summary += std::format("{} files over the memory limit stored uncompressed because their method "
+                               "cannot be streamed:\n", storedTooLarge.size());
+        for (const auto& name : storedTooLarge) {
+            summary += std::format("  {}\n", name);
+        }
+    }
+
+    return summary;
+}
+
 PAKWriter::PAKWriter(PackageBuildData build, const char* packagePath, ProgressCallback cb)
     : m_build(std::move(build)), m_packagePath(packagePath), m_cb(std::move(cb))
 {
     m_metadata.version = static_cast<uint32_t>(m_build.version);
     m_metadata.flags = m_build.flags;
     m_metadata.priority = m_build.priority;
+
+    if (m_build.sharedBlocks) {
+        m_metadata.flags = static_cast<PackageFlags>(static_cast<uint8_t>(m_metadata.flags)
+            | static_cast<uint8_t>(PackageFlags::SharedBlocks));
+    }
 }
 
 void PAKWriter::write()
 {
-    m_stream.open(m_packagePath.c_str(), "wb");
+    m_outputPath = m_packagePath;
+
+    if (m_build.incremental) {
+        openPrevious();
+    } else {
+        // A stale manifest would describe the wrong archive
+        std::error_code ec;
+        fs::remove(PackageManifest::pathFor(m_packagePath), ec);
+    }
+
+    // The previous package stays readable while its replacement is written alongside
+    if (m_hasPrevious) {
+        m_outputPath += ".tmp";
+    }
+
+    if (m_build.dictionary && m_build.compression == CompressionMethod::ZSTD) {
+        trainDictionary();
+    }
+
+    m_stream.open(m_outputPath.c_str(), "wb");
 
     m_stream.write<uint32_t>(PAK_MAGIC);
 
     auto header = LSPKHeader16::fromCommon(m_metadata);
     m_stream.write<LSPKHeader16>(header);
 
+    if (m_dictionary) {
+        writeDictionary();
+    }
+
+    if (m_build.hash) {
+        // The archive MD5 covers file contents in alphabetical order; packing in that order
+        // lets the digest be accumulated as each file is committed
+        std::ranges::stable_sort(m_build.files, [](const PackageBuildInputFile& a, const PackageBuildInputFile& b) {
+            return std::ranges::lexicographical_compare(a.name, b.name);
+        });
+    }
+
     auto writtenFiles = packFiles();
 
     m_metadata.fileListOffset = m_stream.tell();
@@ -36,7 +210,7 @@ void PAKWriter::write()
     m_metadata.fileListSize = static_cast<uint32_t>(m_stream.tell() - m_metadata.fileListOffset);
 
     if (m_build.hash) {
-        archiveHash(m_metadata.md5);
+        m_md5.finalize(m_metadata.md5);
     } else {
         memset(m_metadata.md5, 0, 16);
     }
@@ -47,18 +221,93 @@ void PAKWriter::write()
 
     header = LSPKHeader16::fromCommon(m_metadata);
     m_stream.write<LSPKHeader16>(header);
+
+    if (m_build.incremental) {
+        finishIncremental();
+    }
+}
+
+void PAKWriter::openPrevious()
+{
+    if (!fs::exists(m_packagePath) || !m_previousManifest.load(PackageManifest::pathFor(m_packagePath))) {
+        return;
+    }
+
+    try {
+        m_previous.read(m_packagePath.c_str());
+
+        // The manifest must have been written for this very package, not one since replaced
+        auto stat = statFile(m_packagePath);
+        const auto& archive = m_previousManifest.archive();
+
+        m_hasPrevious = archive.size == stat.size && archive.mtime == stat.mtime
+            && archive.fileListOffset == m_previous.package().m_header.fileListOffset;
+    } catch (const std::exception&) {
+        // Unreadable previous package; fall back to a full build
+    }
+
+    if (!m_hasPrevious) {
+        m_previous.close();
+        m_previousManifest.clear();
+    }
+}
+
+void PAKWriter::finishIncremental()
+{
+    m_stream.close();
+
+    if (m_hasPrevious) {
+        m_previous.close();
+        m_hasPrevious = false;
+
+        if (!MoveFileExA(m_outputPath.c_str(), m_packagePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            throw Exception(GetLastError());
+        }
+    }
+
+    auto stat = statFile(m_packagePath);
+    m_manifest.setArchive({stat.size, stat.mtime, m_metadata.fileListOffset});
+
+    m_manifest.save(PackageManifest::pathFor(m_packagePath));
 }
 
 void PAKWriter::writeCompressedFileList(const std::vector<PackagedFileInfoCommon>& files)
 {
-    Stream fileList;
+    // The entries are fixed-size, so the table is sized once and each entry written in place
+    auto fileListSize = files.size() * sizeof(FileEntry18);
+    auto fileList = std::make_unique<uint8_t[]>(fileListSize);
+    auto* entries = reinterpret_cast<FileEntry18*>(fileList.get());
+
+    auto fill = [&](size_t first, size_t last) {
+        for (auto i = first; i < last; ++i) {
+            entries[i] = FileEntry18::fromCommon(files[i]);
+        }
+    };
 
-    for (const auto& file : files) {
-        auto entry = FileEntry18::fromCommon(file);
-        fileList.write<FileEntry18>(entry);
+    auto threads = ThreadPool::threadCount(m_build.threads);
+    if (threads == 1 || files.size() < FILE_LIST_PARALLEL_MIN) {
+        fill(0, files.size());
+    } else {
+        ThreadPool pool(threads);
+        auto chunkSize = (files.size() + pool.size() - 1) / pool.size();
+
+        std::vector<std::future<void>> chunks;
+        for (size_t first = 0; first < files.size(); first += chunkSize) {
+            chunks.push_back(pool.submit([&fill, first, last = std::min(first + chunkSize, files.size())] {
+                fill(first, last);
+            }));
+        }
+
+        for (auto& chunk : chunks) {
+            chunk.get();
+        }
     }
 
-    auto compressedFileList = LZ4Codec::encode(fileList, 0, fileList.size());
+    // The table is mostly zero padding and repeated path prefixes, which LZ4 HC packs far tighter;
+    // the game reads either form with the same block decoder
+    auto compressedFileList = m_build.compressionLevel == LSCompressionLevel::MAX
+                                  ? LZ4Codec::encodeHC(fileList.get(), fileListSize, LZ4HC_CLEVEL_MAX)
+                                  : LZ4Codec::encode(fileList.get(), fileListSize);
 
     m_stream.write<uint32_t>(static_cast<uint32_t>(files.size()));
 
@@ -73,39 +322,121 @@ void PAKWriter::writeCompressedFileList(const std::vector<PackagedFileInfoCommon
     m_stream.write(data.get(), size);
 }
 
-void PAKWriter::archiveHash(uint8_t digest[16])
+void PAKWriter::trainDictionary()
 {
-    // MD5 is computed over the contents of all files in an alphabetically sorted order
-    std::ranges::sort(m_build.files, [](const PackageBuildInputFile& a, const PackageBuildInputFile& b) {
-        return std::ranges::lexicographical_compare(a.name, b.name);
-    });
+    std::vector<const PackageBuildInputFile*> candidates;
+    uintmax_t candidateBytes = 0;
 
-    MD5 md5;
     for (const auto& file : m_build.files) {
+        if (!canCompressFile(file)) {
+            continue;
+        }
+
+        auto size = fs::file_size(file.filename);
+        if (size > 0 && size <= DICTIONARY_SAMPLE_LIMIT) {
+            candidates.push_back(&file);
+            candidateBytes += size;
+        }
+    }
+
+    // Spread the samples evenly over the tree rather than taking the first directories only
+    auto stride = std::max<uintmax_t>(1, (candidateBytes + DICTIONARY_SAMPLE_BUDGET - 1) / DICTIONARY_SAMPLE_BUDGET);
+
+    std::vector<ByteBuffer> samples;
+    for (size_t i = 0; i < candidates.size(); i += stride) {
         FileStream input;
-        input.open(file.filename.c_str(), "rb");
+        input.open(candidates[i]->filename.c_str(), "rb");
+        samples.emplace_back(input.read(input.size()).detach());
+    }
 
-        auto buffer = input.read(input.size()).detach();
-        md5.update(buffer.first.get(), static_cast<uint32_t>(buffer.second));
+    m_dictionary = ZSTDDictionary::train(samples, DICTIONARY_SIZE, m_build.compressionLevel);
+    if (m_dictionary == nullptr) {
+        return; // too little to train on; the package is built with plain ZSTD
     }
 
-    md5.finalize(digest);
+    m_metadata.flags = static_cast<PackageFlags>(static_cast<uint8_t>(m_metadata.flags)
+        | static_cast<uint8_t>(PackageFlags::Dictionary));
+}
+
+void PAKWriter::writeDictionary()
+{
+    // Readers find the dictionary at the start of the data area, before the first file
+    m_stream.write<uint32_t>(static_cast<uint32_t>(m_dictionary->size()));
+    m_stream.write(m_dictionary->data(), m_dictionary->size());
+}
+
+Stream PAKWriter::compress(const uint8_t* data, size_t size, CompressionMethod method, LSCompressionLevel level) const
+{
+    if (m_dictionary && method == CompressionMethod::ZSTD) {
+        return Compression::compress(data, size, *m_dictionary);
+    }
+
+    return Compression::compress(method, data, size, level);
 }
 
 std::vector<PackagedFileInfoCommon> PAKWriter::packFiles()
 {
+    const auto& files = m_build.files;
+
     std::vector<PackagedFileInfoCommon> writtenFiles;
-    writtenFiles.reserve(m_build.files.size());
+    writtenFiles.reserve(files.size());
 
-    for (size_t i = 0; i < m_build.files.size(); i++) {
-        const auto& file = m_build.files[i];
-        writtenFiles.emplace_back(writeFile(file));
+    auto threads = ThreadPool::threadCount(m_build.threads);
+    if (threads == 1) {
+        for (size_t i = 0; i < files.size(); i++) {
+            commitFile(compressFile(files[i]), writtenFiles);
+
+            if (m_cb) {
+                m_cb(i + 1, files.size(), files[i].name);
+            }
+        }
+
+        flushBlock(writtenFiles);
+
+        return writtenFiles;
+    }
+
+    // Workers compress ahead while this thread appends the results in input order,
+    // so the archive layout is identical to a serial build
+    ThreadPool pool(threads);
+    const size_t maxInFlight = pool.size() * 2;
+
+    std::deque<std::pair<std::future<CompressedFile>, uintmax_t>> pending;
+    uintmax_t pendingBytes = 0;
+    size_t next = 0;
+
+    for (size_t i = 0; i < files.size(); i++) {
+        // Look ahead while the loaded inputs fit in the memory limit; streamed files are never loaded
+        for (; next < files.size() && pending.size() < maxInFlight; ++next) {
+            auto size = fs::file_size(files[next].filename);
+            if (size > m_build.memoryLimit) {
+                size = 0;
+            }
+
+            if (!pending.empty() && pendingBytes + size > m_build.memoryLimit) {
+                break;
+            }
+
+            pending.emplace_back(pool.submit([this, &file = files[next]] {
+                return compressFile(file);
+            }), size);
+
+            pendingBytes += size;
+        }
+
+        auto compressed = pending.front().first.get();
+        pendingBytes -= pending.front().second;
+        pending.pop_front();
+
+        commitFile(std::move(compressed), writtenFiles);
 
         if (m_cb) {
-            m_cb(i + 1, m_build.files.size(), file.name);
+            m_cb(i + 1, files.size(), files[i].name);
         }
     }
 
+    flushBlock(writtenFiles);
+
     return writtenFiles;
 }
 
@@ -134,9 +465,9 @@ void PAKWriter::writePadding()
     }
 }
 
-bool PAKWriter::canCompressFile(const PackageBuildInputFile& inputFile)
+bool PAKWriter::canCompressFile(const PackageBuildInputFile& inputFile) const
 {
-    if (m_build.compression == CompressionMethod::NONE) {
+    if (m_build.compression == CompressionMethod::NONE && !m_build.adaptive) {
         return false;
     }
 
@@ -155,7 +486,7 @@ bool PAKWriter::canCompressFile(const PackageBuildInputFile& inputFile)
     return true;
 }
 
-PackagedFileInfoCommon PAKWriter::writeFile(const PackageBuildInputFile& inputFile)
+PAKWriter::CompressedFile PAKWriter::compressFile(const PackageBuildInputFile& inputFile) const
 {
     FileStream input;
     input.open(inputFile.filename.c_str(), "rb");
@@ -169,35 +500,333 @@ PackagedFileInfoCommon PAKWriter::writeFile(const PackageBuildInputFile& inputFi
     }
 
     auto size = input.size();
-    auto data = input.read(size).detach();
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        throw Exception(std::format("File \"{}\" exceeds the 4 GB limit of the PAK format.", inputFile.name));
+    }
 
-    PackagedFileInfoCommon packaged{};
+    CompressedFile file{};
+    file.input = &inputFile;
+
+    auto& packaged = file.info;
     packaged.name = inputFile.name;
     packaged.uncompressedSize = static_cast<uint32_t>(size);
     packaged.sizeOnDisk = static_cast<uint32_t>(size);
     packaged.archivePart = 0;
-    packaged.offsetInFile = m_stream.tell();
+
+    // Files over the memory limit are compressed in chunks as they are written
+    file.streamed = size > m_build.memoryLimit;
+
+    if (m_build.adaptive && canCompressFile(inputFile) && size > 0) {
+        method = chooseMethod(input, file);
+        level = method == CompressionMethod::NONE ? LSCompressionLevel::DEFAULT : m_build.compressionLevel;
+    }
+
+    if (file.streamed && !Compression::canStream(method)) {
+        file.tooLarge = method != CompressionMethod::NONE;
+        method = CompressionMethod::NONE;
+        level = LSCompressionLevel::DEFAULT;
+    }
+
     packaged.flags = Compression::compressionFlags(method, level);
+    file.level = level;
 
-    if (method != CompressionMethod::NONE) {
-        auto compressed = Compression::compress(method, data.first.get(), size, level);
-        packaged.sizeOnDisk = static_cast<uint32_t>(compressed.size());
-        m_stream.write(compressed);
-    } else {
-        m_stream.write(data.first.get(), data.second);
+    if (m_build.incremental) {
+        file.record = statFile(inputFile.filename);
+        if (reuseFile(file)) {
+            return file;
+        }
+    }
+
+    if (file.streamed) {
+        return file;
+    }
+
+    // Small files are compressed together once their shared block fills
+    file.member = m_build.sharedBlocks && method != CompressionMethod::NONE && method == m_build.compression
+        && size > 0 && size <= BLOCK_MEMBER_LIMIT;
+
+    auto data = input.read(size).detach();
+
+    input.close();
+
+    if (m_build.incremental && file.record.md5.empty()) {
+        file.record.md5 = contentDigest(data.first.get(), data.second);
     }
 
     if (m_build.version >= PackageVersion::V10 && m_build.version <= PackageVersion::V16) {
         packaged.crc = CRC32::compute(data.first.get(), data.second);
     }
 
+    if (method != CompressionMethod::NONE && !file.member) {
+        auto compressed = compress(data.first.get(), size, method, level);
+        packaged.sizeOnDisk = static_cast<uint32_t>(compressed.size());
+        file.data = compressed.detach();
+
+        if (m_build.hash) {
+            file.raw = std::move(data);
+        }
+    } else {
+        file.data = std::move(data);
+    }
+
+    return file;
+}
+
+CompressionMethod PAKWriter::chooseMethod(FileStream& input, CompressedFile& file) const
+{
+    auto sample = input.read(std::min<size_t>(input.size(), ADAPTIVE_SAMPLE_SIZE));
+    input.seek(0, SeekMode::Begin);
+
+    auto size = sample.size();
+    auto lz4 = Compression::compress(CompressionMethod::LZ4, sample.data(), size, LSCompressionLevel::FAST).size();
+    auto zstd = Compression::compress(CompressionMethod::ZSTD, sample.data(), size, LSCompressionLevel::FAST).size();
+
+    if (static_cast<double>(std::min(lz4, zstd)) > static_cast<double>(size) * (1.0 - ADAPTIVE_MIN_GAIN)) {
+        file.lowGain = true;
+        return CompressionMethod::NONE;
+    }
+
+    // LZ4 block compression cannot be streamed, so large files always take ZSTD
+    if (file.streamed || static_cast<double>(zstd) < static_cast<double>(lz4) * (1.0 - ADAPTIVE_ZSTD_GAIN)) {
+        return CompressionMethod::ZSTD;
+    }
+
+    return CompressionMethod::LZ4;
+}
+
+void PAKWriter::summarize(const CompressedFile& file)
+{
+    auto& totals = m_summary[Compression::compressionMethod(file.info.flags)];
+    ++totals.files;
+    totals.size += file.info.uncompressedSize;
+
+    // Block members are counted on disk once, with their block
+    if (!file.member) {
+        totals.sizeOnDisk += file.info.sizeOnDisk;
+    }
+
+    if (file.lowGain) {
+        ++m_summary.lowGain;
+    }
+
+    if (file.reused) {
+        ++m_summary.reused;
+    } else if (file.tooLarge) {
+        m_summary.storedTooLarge.push_back(file.info.name);
+    }
+}
+
+const PackageBuildSummary& PAKWriter::summary() const
+{
+    return m_summary;
+}
+
+void PAKWriter::commitFile(CompressedFile&& file, std::vector<PackagedFileInfoCommon>& writtenFiles)
+{
+    if (!file.member) {
+        writtenFiles.emplace_back(writeFile(std::move(file)));
+        return;
+    }
+
+    summarize(file);
+
+    if (m_build.incremental) {
+        m_manifest.set(file.info.name, std::move(file.record));
+    }
+
+    if (m_build.hash) {
+        m_md5.update(file.data.first.get(), file.data.second);
+    }
+
+    // The entry's offset and size on disk are those of the block, filled in when it is written
+    m_blockBytes += file.data.second;
+    m_block.emplace_back(writtenFiles.size(), std::move(file.data));
+    writtenFiles.emplace_back(std::move(file.info));
+
+    if (m_blockBytes >= SHARED_BLOCK_SIZE) {
+        flushBlock(writtenFiles);
+    }
+}
+
+void PAKWriter::flushBlock(std::vector<PackagedFileInfoCommon>& writtenFiles)
+{
+    if (m_block.empty()) {
+        return;
+    }
+
+    // Members are laid out in file-list order, which is how readers locate them within the block
+    auto block = std::make_unique<uint8_t[]>(m_blockBytes);
+
+    size_t offset = 0;
+    for (const auto& [index, data] : m_block) {
+        memcpy(block.get() + offset, data.first.get(), data.second);
+        offset += data.second;
+    }
+
+    auto compressed = compress(block.get(), m_blockBytes, m_build.compression, m_build.compressionLevel).detach();
+
+    auto blockOffset = m_stream.tell();
+    m_stream.write(compressed.first.get(), compressed.second);
+
+    m_summary[m_build.compression].sizeOnDisk += compressed.second;
+
+    for (const auto& index : m_block | std::views::keys) {
+        auto& packaged = writtenFiles[index];
+        packaged.offsetInFile = blockOffset;
+        packaged.sizeOnDisk = static_cast<uint32_t>(compressed.second);
+    }
+
+    writePadding();
+
+    m_block.clear();
+    m_blockBytes = 0;
+}
+
+PackagedFileInfoCommon PAKWriter::writeFile(CompressedFile&& file)
+{
+    auto& packaged = file.info;
+    packaged.offsetInFile = m_stream.tell();
+
+    if (file.reused) {
+        copyFile(file);
+    } else if (file.streamed) {
+        streamFile(file);
+    } else {
+        m_stream.write(file.data.first.get(), file.data.second);
+    }
+
+    if (m_build.incremental) {
+        m_manifest.set(packaged.name, std::move(file.record));
+    }
+
+    if (m_build.hash && !file.streamed && !file.reused) {
+        auto compressed = Compression::compressionMethod(packaged.flags) != CompressionMethod::NONE;
+        const auto& contents = compressed ? file.raw : file.data;
+        m_md5.update(contents.first.get(), contents.second);
+    }
+
     if (static_cast<uint8_t>(m_build.flags) & static_cast<uint8_t>(PackageFlags::Solid)) {
         writePadding();
     }
 
-    input.close();
+    summarize(file);
+
+    return std::move(packaged);
+}
+
+void PAKWriter::streamFile(CompressedFile& file)
+{
+    FileStream input;
+    input.open(file.input->filename.c_str(), "rb");
+
+    auto& packaged = file.info;
+    auto method = Compression::compressionMethod(packaged.flags);
+    auto computeCrc = m_build.version >= PackageVersion::V10 && m_build.version <= PackageVersion::V16;
+
+    MD5 contentHash;
+
+    auto reader = [&](uint8_t* buffer, size_t size) {
+        auto read = input.read(reinterpret_cast<char*>(buffer), size);
+
+        if (m_build.hash) {
+            m_md5.update(buffer, read);
+        }
+
+        if (m_build.incremental) {
+            contentHash.update(buffer, read);
+        }
+
+        if (computeCrc) {
+            packaged.crc = CRC32::update(packaged.crc, buffer, read);
+        }
+
+        return read;
+    };
+
+    auto writer = [&](const uint8_t* data, size_t size) {
+        m_stream.write(data, size);
+    };
+
+    size_t sizeOnDisk = 0;
+
+    if (method == CompressionMethod::NONE) {
+        auto buffer = std::make_unique<uint8_t[]>(STREAM_CHUNK_SIZE);
+        for (size_t read; (read = reader(buffer.get(), STREAM_CHUNK_SIZE)) > 0;) {
+            writer(buffer.get(), read);
+            sizeOnDisk += read;
+        }
+    } else {
+        sizeOnDisk = Compression::compress(method, reader, writer, file.level);
+    }
+
+    if (sizeOnDisk > std::numeric_limits<uint32_t>::max()) {
+        throw Exception(std::format("File \"{}\" exceeds the 4 GB limit of the PAK format.", packaged.name));
+    }
+
+    packaged.sizeOnDisk = static_cast<uint32_t>(sizeOnDisk);
+
+    if (m_build.incremental) {
+        file.record.md5 = hexDigest(contentHash);
+    }
+}
 
-    return packaged;
+bool PAKWriter::reuseFile(CompressedFile& file) const
+{
+    if (!m_hasPrevious) {
+        return false;
+    }
+
+    // Entries compressed against a dictionary can only be read with that same dictionary
+    auto previousFlags = static_cast<uint8_t>(m_previous.package().m_header.flags);
+    if (m_dictionary || previousFlags & static_cast<uint8_t>(PackageFlags::Dictionary)) {
+        return false;
+    }
+
+    const auto* previous = m_previousManifest.find(file.info.name);
+    const auto* entry = m_previous.find(file.info.name);
+
+    // The entry must have been stored on its own with the compression this build would choose, and hold
+    // as many bytes as the manifest recorded for it
+    if (previous == nullptr || entry == nullptr || entry->isBlockMember() || entry->flags != file.info.flags
+        || previous->size != file.record.size || entry->size() != previous->size) {
+        return false;
+    }
+
+    if (previous->mtime != file.record.mtime) {
+        // Touched since the last build; only the contents can tell whether it changed
+        file.record.md5 = contentDigest(file.input->filename);
+        if (file.record.md5 != previous->md5) {
+            return false;
+        }
+    } else {
+        file.record.md5 = previous->md5;
+    }
+
+    file.reused = entry;
+    file.info.sizeOnDisk = entry->sizeOnDisk;
+    file.info.crc = entry->crc;
+
+    return true;
+}
+
+void PAKWriter::copyFile(CompressedFile& file)
+{
+    // Copy the compressed bytes straight from the previous archive
+    const auto& entry = *file.reused;
+    const auto& package = m_previous.package();
+
+    auto buffer = std::make_unique<uint8_t[]>(STREAM_CHUNK_SIZE);
+
+    for (uint64_t copied = 0; copied < entry.sizeOnDisk;) {
+        auto chunk = std::min<uint64_t>(STREAM_CHUNK_SIZE, entry.sizeOnDisk - copied);
+        package.readAt(entry.archivePart, entry.offsetInFile + copied, buffer.get(), chunk);
+        m_stream.write(buffer.get(), chunk);
+        copied += chunk;
+    }
+
+    if (m_build.hash) {
+        hashFile(m_md5, file.input->filename);
+    }
 }
 
 void PAKWriter::close()
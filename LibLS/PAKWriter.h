@@ -1,6 +1,31 @@
 #pragma once
 
+#include "MD5.h"
 #include "Package.h"
+#include "PackageManifest.h"
+#include "PAKReader.h"
+#include "ZSTDDictionary.h"
+
+// What a build did with its inputs, totalled by the compression method of the entries
+struct PackageBuildSummary
+{
+    struct Totals
+    {
+        size_t files{0};
+        uint64_t size{0};
+        uint64_t sizeOnDisk{0};
+    };
+
+    std::array<Totals, 4> methods{}; // indexed by CompressionMethod
+    size_t lowGain{0}; // stored because the estimated gain was too small (adaptive builds only)
+    size_t reused{0}; // copied unchanged from the previous package (incremental builds only)
+    std::vector<std::string> storedTooLarge; // over the memory limit with a method that cannot stream (LZ4)
+
+    Totals& operator[](CompressionMethod method);
+    const Totals& operator[](CompressionMethod method) const;
+
+    std::string format() const;
+};
 
 class PAKWriter
 {
@@ -13,18 +38,58 @@ public:
     void write();
     void close();
 
+    const PackageBuildSummary& summary() const;
+
 private:
-    bool canCompressFile(const PackageBuildInputFile& inputFile);
-    PackagedFileInfoCommon writeFile(const PackageBuildInputFile& inputFile);
+    // A file read and compressed, awaiting its place in the archive
+    struct CompressedFile
+    {
+        const PackageBuildInputFile* input{nullptr};
+        PackagedFileInfoCommon info;
+        LSCompressionLevel level{LSCompressionLevel::DEFAULT};
+        ByteBuffer data;
+        ByteBuffer raw; // uncompressed contents, kept only when they are needed for the archive hash
+        bool streamed{false}; // too large to load; compressed in chunks as it is written
+        bool member{false}; // small file kept uncompressed until its shared block is written
+        bool lowGain{false}; // stored because compression was estimated not to pay off
+        bool tooLarge{false}; // stored because it is streamed and its method cannot be
+        const PackagedFileInfo* reused{nullptr}; // unchanged entry copied from the previous package
+        PackageManifestEntry record; // incremental builds only
+    };
+
+    bool canCompressFile(const PackageBuildInputFile& inputFile) const;
+    CompressionMethod chooseMethod(FileStream& input, CompressedFile& file) const;
+    void summarize(const CompressedFile& file);
+    CompressedFile compressFile(const PackageBuildInputFile& inputFile) const;
+    void commitFile(CompressedFile&& file, std::vector<PackagedFileInfoCommon>& writtenFiles);
+    PackagedFileInfoCommon writeFile(CompressedFile&& file);
+    void flushBlock(std::vector<PackagedFileInfoCommon>& writtenFiles);
+    void streamFile(CompressedFile& file);
+    void copyFile(CompressedFile& file);
+    bool reuseFile(CompressedFile& file) const;
+    void openPrevious();
+    void finishIncremental();
     std::vector<PackagedFileInfoCommon> packFiles();
-    void archiveHash(uint8_t digest[16]);
     void writeCompressedFileList(const std::vector<PackagedFileInfoCommon>& files);
+    void trainDictionary();
+    void writeDictionary();
+    Stream compress(const uint8_t* data, size_t size, CompressionMethod method, LSCompressionLevel level) const;
     void writePadding();
 
     PackageHeaderCommon m_metadata{};
     PackageBuildData m_build{};
     FileStream m_stream;
+    MD5 m_md5;
     Package m_package;
     std::string m_packagePath;
+    std::string m_outputPath;
+    PAKReader m_previous;
+    PackageManifest m_previousManifest;
+    PackageManifest m_manifest;
+    bool m_hasPrevious{false};
+    std::vector<std::pair<size_t, ByteBuffer>> m_block; // pending shared block members: (written index, contents)
+    size_t m_blockBytes{0};
+    std::unique_ptr<ZSTDDictionary> m_dictionary;
+    PackageBuildSummary m_summary;
     ProgressCallback m_cb;
 };
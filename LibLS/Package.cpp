@@ -1,4 +1,5 @@
 #include "pch.h"
+#include "Exception.h"
 #include "Package.h"
 
 PAKHeader LSPKHeader16::commonHeader() const
@@ -9,9 +10,10 @@ PAKHeader LSPKHeader16::commonHeader() const
     header.dataOffset = 0;
     header.fileListOffset = fileListOffset;
     header.fileListSize = fileListSize;
-    header.numParts = 1;
+    header.numParts = numParts;
     header.flags = static_cast<PackageFlags>(flags);
     header.priority = priority;
+    memcpy(header.md5, md5, sizeof(md5));
 
     return header;
 }
@@ -24,14 +26,19 @@ LSPKHeader16 LSPKHeader16::fromCommon(const PackageHeaderCommon& h)
     header.fileListSize = h.fileListSize;
     header.flags = static_cast<uint8_t>(h.flags);
     header.priority = h.priority;
+    memcpy(header.md5, h.md5, sizeof(h.md5));
     header.numParts = static_cast<uint16_t>(h.numParts);
     return header;
 }
 
 FileEntry18 FileEntry18::fromCommon(const PackagedFileInfoCommon& info)
 {
+    if (info.name.size() >= sizeof(FileEntry18::name)) {
+        throw Exception(std::format("File name \"{}\" is too long for the package file list.", info.name));
+    }
+
     FileEntry18 entry{};
-    strncpy_s(entry.name, info.name.c_str(), sizeof(entry.name));
+    memcpy(entry.name, info.name.data(), info.name.size());
     entry.offsetInFile1 = static_cast<uint32_t>(info.offsetInFile & 0xFFFFFFFF);
     entry.offsetInFile2 = static_cast<uint16_t>(info.offsetInFile >> 32 & 0xFFFF);
     entry.archivePart = static_cast<uint8_t>(info.archivePart);
@@ -48,6 +55,8 @@ Package::Package(Package&& rhs) noexcept
     m_filemap = std::move(rhs.m_filemap);
     m_filename = std::move(rhs.m_filename);
     m_file = std::move(rhs.m_file);
+    m_mapping = std::move(rhs.m_mapping);
+    m_parts = std::move(rhs.m_parts);
 }
 
 Package& Package::operator=(Package&& rhs) noexcept
@@ -58,7 +67,110 @@ Package& Package::operator=(Package&& rhs) noexcept
         m_filemap = std::move(rhs.m_filemap);
         m_filename = std::move(rhs.m_filename);
         m_file = std::move(rhs.m_file);
+        m_mapping = std::move(rhs.m_mapping);
+        m_parts = std::move(rhs.m_parts);
     }
 
     return *this;
 }
+
+PackagedFileData::PackagedFileData(const uint8_t* data, size_t size) : m_data(data), m_size(size)
+{
+}
+
+PackagedFileData::PackagedFileData(ByteBuffer buffer) : m_buffer(std::move(buffer))
+{
+    m_data = m_buffer.first.get();
+    m_size = m_buffer.second;
+}
+
+const uint8_t* PackagedFileData::data() const
+{
+    return m_data;
+}
+
+size_t PackagedFileData::size() const
+{
+    return m_size;
+}
+
+bool PackagedFileData::isView() const
+{
+    return m_data != nullptr && m_buffer.first == nullptr;
+}
+
+ByteBuffer PackagedFileData::detach()
+{
+    ByteBuffer buffer;
+
+    if (isView()) {
+        buffer = {std::make_unique<uint8_t[]>(m_size), m_size};
+        memcpy(buffer.first.get(), m_data, m_size);
+    } else {
+        buffer = std::move(m_buffer);
+    }
+
+    m_buffer = {};
+    m_data = nullptr;
+    m_size = 0;
+
+    return buffer;
+}
+
+bool Package::isMapped() const
+{
+    return m_mapping.isOpen();
+}
+
+const uint8_t* Package::view(uint32_t part, uint64_t offset, size_t size) const
+{
+    if (!isMapped()) {
+        throw Exception("Package is not memory-mapped.");
+    }
+
+    const auto& mapping = part == 0 ? m_mapping : openPart(part).mapping;
+
+    if (offset > mapping.size() || size > mapping.size() - offset) {
+        throw Exception("Packaged file lies outside of the archive.");
+    }
+
+    return mapping.data() + offset;
+}
+
+std::string Package::partPath(const std::string& filename, uint32_t part)
+{
+    if (part == 0) {
+        return filename;
+    }
+
+    std::filesystem::path path(filename);
+    auto partName = std::format("{}_{}{}", path.stem().string(), part, path.extension().string());
+
+    return (path.parent_path() / partName).string();
+}
+
+const PackagePart& Package::openPart(uint32_t part) const
+{
+    if (part == 0 || part > m_parts.size()) {
+        throw Exception(std::format("Archive part {} does not exist.", part));
+    }
+
+    auto& entry = *m_parts[part - 1];
+
+    std::call_once(entry.opened, [&] {
+        auto path = partPath(m_filename, part);
+
+        entry.file.open(path.c_str(), "rb");
+
+        if (isMapped()) {
+            try {
+                entry.mapping.open(path.c_str());
+            } catch (...) {
+                entry.file.close();
+                throw;
+            }
+        }
+    });
+
+    return entry;
+}
@@ -2,6 +2,9 @@
 
 #include "Compress.h"
 #include "FileStream.h"
+#include "MappedFile.h"
+
+#include <mutex>
 
 struct PackagedFileInfoCommon;
 
@@ -11,7 +14,9 @@ enum class PackageFlags : uint8_t
 {
     allowMemoryMapping = 0x02, // Allow memory-mapped access to the files in this archive.
     Solid = 0x04, // All files are compressed into a single LZ4 stream
-    Preload = 0x08 // Archive contents should be preloaded on game startup.
+    Preload = 0x08, // Archive contents should be preloaded on game startup.
+    Dictionary = 0x10, // ZSTD entries share a dictionary stored ahead of the file data; not understood by the game
+    SharedBlocks = 0x20 // Small files are compressed together in blocks whose entries all point at the block; not understood by the game
 };
 
 struct PAKHeader
@@ -115,6 +120,36 @@ struct PackagedFileInfo : PackagedFileInfoCommon
     {
         return method() == CompressionMethod::NONE ? sizeOnDisk : uncompressedSize;
     }
+
+    bool isBlockMember() const
+    {
+        return blockSize != 0;
+    }
+
+    // Packages with shared blocks only: offset of the file within its block, and the block's decompressed size
+    uint32_t blockOffset{0};
+    uint32_t blockSize{0};
+};
+
+// Contents of a packaged file, either owned or viewed in place in a memory-mapped archive.
+// A view is only valid while the package it was read from remains open.
+class PackagedFileData
+{
+public:
+    PackagedFileData() = default;
+    PackagedFileData(const uint8_t* data, size_t size);
+    explicit PackagedFileData(ByteBuffer buffer);
+
+    const uint8_t* data() const;
+    size_t size() const;
+    bool isView() const;
+
+    ByteBuffer detach();
+
+private:
+    ByteBuffer m_buffer{};
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
 };
 
 struct PackageBuildInputFile
@@ -134,6 +169,20 @@ struct PackageBuildData final
     std::vector<PackageBuildInputFile> files;
     bool excludeHidden{true};
     uint8_t priority{0};
+    uint32_t threads{0}; // compression workers; zero uses the hardware concurrency, one builds serially
+    size_t memoryLimit{256 * 1024 * 1024}; // approximate ceiling on file data held in memory; larger files are streamed
+    bool incremental{false}; // reuse unchanged entries from the package already at the output path
+    bool dictionary{false}; // ZSTD only: train a shared dictionary from a sample of the files and compress with it
+    bool adaptive{false}; // store, LZ4 or ZSTD per file from an estimate of its compression ratio
+    bool sharedBlocks{false}; // compress small files together in shared blocks, marked with PackageFlags::SharedBlocks
+};
+
+// Secondary archive file (<name>_<part>.pak) of a multi-part package, opened on first access
+struct PackagePart
+{
+    std::once_flag opened;
+    FileStream file;
+    MappedFile mapping;
 };
 
 struct Package final
@@ -148,20 +197,32 @@ struct Package final
     Package& operator=(const Package&) = delete;
 
     void addFile(const PackagedFileInfo& file);
-    bool load(const char* filename);
+    bool load(const char* filename, bool memoryMapped = false);
+    void initParts();
     void seek(int64_t offset, SeekMode mode);
     void reset();
 
+    bool isMapped() const;
+    const uint8_t* view(uint32_t part, uint64_t offset, size_t size) const;
+
     template <typename T>
     T read();
 
     void read(void* buffer, std::size_t size);
+    void readAt(uint32_t part, uint64_t offset, void* buffer, std::size_t size) const;
+
+    static std::string partPath(const std::string& filename, uint32_t part);
 
     PAKHeader m_header{};
     std::vector<PackagedFileInfo> m_files{};
     std::unordered_map<std::string, size_t> m_filemap{};
     std::string m_filename{};
     FileStream m_file{};
+    MappedFile m_mapping{};
+    std::vector<std::unique_ptr<PackagePart>> m_parts{}; // parts 1..numParts-1; part 0 is m_file
+
+private:
+    const PackagePart& openPart(uint32_t part) const;
 };
 
 template <typename T>
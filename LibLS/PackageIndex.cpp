@@ -0,0 +1,279 @@
+#include "pch.h"
+#include "FileStream.h"
+#include "FNVHash.h"
+#include "PackageIndex.h"
+
+#include <numeric>
+#include <shlobj_core.h>
+
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+constexpr uint32_t INDEX_MAGIC = 0x49505342; // "BSPI"
+constexpr uint32_t INDEX_VERSION = 3;
+
+} // anonymous namespace
+
+#pragma pack(push, 1)
+
+struct PackageIndex::Header
+{
+    uint32_t magic;
+    uint32_t version;
+    PackageIndexKey key;
+    uint32_t numFiles;
+    uint32_t stringPoolSize;
+};
+
+struct PackageIndex::Entry
+{
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint64_t offsetInFile;
+    uint32_t sizeOnDisk;
+    uint32_t uncompressedSize;
+    uint32_t archivePart;
+    uint32_t crc;
+    uint8_t flags;
+    uint32_t blockOffset;
+    uint32_t blockSize;
+};
+
+#pragma pack(pop)
+
+bool PackageIndex::open(const std::string& path, const PackageIndexKey& key)
+{
+    close();
+
+    if (!fs::exists(path)) {
+        return false;
+    }
+
+    try {
+        m_file.open(path.c_str());
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    const auto* header = indexHeader();
+    auto valid = header != nullptr
+        && header->magic == INDEX_MAGIC
+        && header->version == INDEX_VERSION
+        && memcmp(&header->key, &key, sizeof(key)) == 0;
+
+    if (valid) {
+        auto expected = sizeof(Header)
+            + static_cast<uint64_t>(header->numFiles) * (sizeof(Entry) + sizeof(uint32_t))
+            + header->stringPoolSize;
+        valid = m_file.size() == expected && validate();
+    }
+
+    if (!valid) {
+        close();
+    }
+
+    return valid;
+}
+
+// Lookups trust the offsets in the mapped file, so a damaged cache must be caught here and rebuilt
+bool PackageIndex::validate() const
+{
+    const auto* header = indexHeader();
+    const auto* base = entries();
+
+    for (uint32_t i = 0; i < header->numFiles; ++i) {
+        const auto& entry = base[i];
+        if (entry.nameOffset > header->stringPoolSize || entry.nameLength > header->stringPoolSize - entry.nameOffset) {
+            return false;
+        }
+    }
+
+    const auto* order = sorted();
+
+    return std::all_of(order, order + header->numFiles, [&](uint32_t index) {
+        return index < header->numFiles;
+    });
+}
+
+void PackageIndex::close()
+{
+    m_file.close();
+}
+
+bool PackageIndex::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+size_t PackageIndex::size() const
+{
+    return isOpen() ? indexHeader()->numFiles : 0;
+}
+
+bool PackageIndex::find(std::string_view name, PackagedFileInfo& info) const
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    const auto* first = sorted();
+    const auto* last = first + indexHeader()->numFiles;
+    const auto* base = entries();
+
+    auto it = std::lower_bound(first, last, name, [&](uint32_t index, std::string_view value) {
+        return nameOf(base[index]) < value;
+    });
+
+    if (it == last || nameOf(base[*it]) != name) {
+        return false;
+    }
+
+    info = infoOf(base[*it]);
+
+    return true;
+}
+
+std::vector<PackagedFileInfo> PackageIndex::files() const
+{
+    std::vector<PackagedFileInfo> files;
+    files.reserve(size());
+
+    const auto* base = entries();
+    for (size_t i = 0; i < size(); ++i) {
+        files.emplace_back(infoOf(base[i]));
+    }
+
+    return files;
+}
+
+void PackageIndex::save(const std::string& path, const PackageIndexKey& key, const std::vector<PackagedFileInfo>& files)
+{
+    Header indexHeader{};
+    indexHeader.magic = INDEX_MAGIC;
+    indexHeader.version = INDEX_VERSION;
+    indexHeader.key = key;
+    indexHeader.numFiles = static_cast<uint32_t>(files.size());
+
+    std::vector<Entry> entries(files.size());
+    std::string strings;
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        const auto& file = files[i];
+        auto& entry = entries[i];
+        entry.nameOffset = static_cast<uint32_t>(strings.size());
+        entry.nameLength = static_cast<uint32_t>(file.name.size());
+        entry.offsetInFile = file.offsetInFile;
+        entry.sizeOnDisk = file.sizeOnDisk;
+        entry.uncompressedSize = file.uncompressedSize;
+        entry.archivePart = file.archivePart;
+        entry.crc = file.crc;
+        entry.flags = static_cast<uint8_t>(file.flags);
+        entry.blockOffset = file.blockOffset;
+        entry.blockSize = file.blockSize;
+        strings += file.name;
+    }
+
+    indexHeader.stringPoolSize = static_cast<uint32_t>(strings.size());
+
+    std::vector<uint32_t> sorted(files.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::ranges::sort(sorted, [&](uint32_t a, uint32_t b) {
+        return files[a].name < files[b].name;
+    });
+
+    fs::create_directories(fs::path(path).parent_path());
+
+    // Write beside the destination and swap in, so readers never see a partial index
+    auto tempPath = path + ".tmp";
+    {
+        FileStream stream;
+        stream.open(tempPath.c_str(), "wb");
+        stream.write(reinterpret_cast<const char*>(&indexHeader), sizeof(indexHeader));
+        stream.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+        stream.write(reinterpret_cast<const char*>(sorted.data()), sorted.size() * sizeof(uint32_t));
+        stream.write(strings.data(), strings.size());
+    }
+
+    if (!MoveFileExA(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        DeleteFileA(tempPath.c_str());
+    }
+}
+
+PackageIndexKey PackageIndex::keyFor(const std::string& packagePath, const PAKHeader& header)
+{
+    PackageIndexKey key{};
+    key.archiveSize = fs::file_size(packagePath);
+    key.mtime = fs::last_write_time(packagePath).time_since_epoch().count();
+    key.fileListOffset = header.fileListOffset;
+    key.fileListSize = header.fileListSize;
+    memcpy(key.md5, header.md5, sizeof(key.md5));
+
+    return key;
+}
+
+std::string PackageIndex::cachePath(const std::string& packagePath)
+{
+    fs::path dir;
+
+    WCHAR appData[MAX_PATH]{};
+    if (SUCCEEDED(SHGetFolderPathW(nullptr, CSIDL_LOCAL_APPDATA, nullptr, 0, appData))) {
+        dir = fs::path(appData) / L"BG3ModStudio" / L"PakIndex";
+    } else {
+        dir = fs::temp_directory_path() / L"BG3ModStudio" / L"PakIndex";
+    }
+
+    // One cache file per archive location
+    auto canonical = fs::absolute(packagePath).generic_string();
+    std::ranges::transform(canonical, canonical.begin(), tolower);
+
+    auto hash = fnvhash::fnv1a_hash(std::as_bytes(std::span(canonical.data(), canonical.size())));
+    auto filename = std::format("{}-{:08x}.idx", fs::path(packagePath).stem().string(), hash);
+
+    return (dir / filename).string();
+}
+
+const PackageIndex::Header* PackageIndex::indexHeader() const
+{
+    if (m_file.size() < sizeof(Header)) {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const Header*>(m_file.data());
+}
+
+const PackageIndex::Entry* PackageIndex::entries() const
+{
+    return reinterpret_cast<const Entry*>(m_file.data() + sizeof(Header));
+}
+
+const uint32_t* PackageIndex::sorted() const
+{
+    return reinterpret_cast<const uint32_t*>(entries() + indexHeader()->numFiles);
+}
+
+const char* PackageIndex::strings() const
+{
+    return reinterpret_cast<const char*>(sorted() + indexHeader()->numFiles);
+}
+
+std::string_view PackageIndex::nameOf(const Entry& entry) const
+{
+    return {strings() + entry.nameOffset, entry.nameLength};
+}
+
+PackagedFileInfo PackageIndex::infoOf(const Entry& entry) const
+{
+    PackagedFileInfo info;
+    info.name = nameOf(entry);
+    info.archivePart = entry.archivePart;
+    info.crc = entry.crc;
+    info.flags = static_cast<CompressionFlags>(entry.flags);
+    info.offsetInFile = entry.offsetInFile;
+    info.sizeOnDisk = entry.sizeOnDisk;
+    info.uncompressedSize = entry.uncompressedSize;
+    info.blockOffset = entry.blockOffset;
+    info.blockSize = entry.blockSize;
+
+    return info;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "MappedFile.h"
+#include "Package.h"
+
+#pragma pack(push, 1)
+
+// Identifies the archive state an index was built from
+struct PackageIndexKey
+{
+    uint64_t archiveSize;
+    int64_t mtime;
+    uint64_t fileListOffset;
+    uint32_t fileListSize;
+    uint8_t md5[16];
+};
+
+#pragma pack(pop)
+
+// Flat, memory-mapped snapshot of a package file list.
+// Entries, a name-sorted index and a string pool are laid out contiguously so that opening
+// a cached index and looking up a name require no parsing and no allocation.
+class PackageIndex
+{
+public:
+    PackageIndex() = default;
+    ~PackageIndex() = default;
+
+    PackageIndex(PackageIndex&&) noexcept = default;
+    PackageIndex& operator=(PackageIndex&&) noexcept = default;
+
+    PackageIndex(const PackageIndex&) = delete;
+    PackageIndex& operator=(const PackageIndex&) = delete;
+
+    // Maps the index at path; fails if it is missing, corrupt or was built for a different key
+    bool open(const std::string& path, const PackageIndexKey& key);
+    void close();
+    bool isOpen() const;
+
+    size_t size() const;
+
+    bool find(std::string_view name, PackagedFileInfo& info) const;
+    std::vector<PackagedFileInfo> files() const;
+
+    static void save(const std::string& path, const PackageIndexKey& key, const std::vector<PackagedFileInfo>& files);
+
+    static PackageIndexKey keyFor(const std::string& packagePath, const PAKHeader& header);
+    static std::string cachePath(const std::string& packagePath);
+
+private:
+    struct Header;
+    struct Entry;
+
+    bool validate() const;
+
+    const Header* indexHeader() const;
+    const Entry* entries() const;
+    const uint32_t* sorted() const;
+    const char* strings() const;
+
+    std::string_view nameOf(const Entry& entry) const;
+    PackagedFileInfo infoOf(const Entry& entry) const;
+
+    MappedFile m_file;
+};
@@ -0,0 +1,110 @@
+#include "pch.h"
+#include "Exception.h"
+#include "PackageManifest.h"
+
+#include <nlohmann/json.hpp>
+
+namespace { // anonymous namespace
+
+constexpr auto MANIFEST_VERSION = 2;
+
+} // anonymous namespace
+
+bool PackageManifest::load(const std::string& path)
+{
+    clear();
+
+    std::ifstream stream(path);
+    if (!stream) {
+        return false;
+    }
+
+    auto doc = nlohmann::json::parse(stream, nullptr, false);
+    if (doc.is_discarded() || doc.value("version", 0) != MANIFEST_VERSION) {
+        return false;
+    }
+
+    const auto& archive = doc["archive"];
+    if (!archive.is_object()) {
+        return false;
+    }
+
+    m_archive.size = archive.value("size", 0ull);
+    m_archive.mtime = archive.value("mtime", 0ll);
+    m_archive.fileListOffset = archive.value("fileListOffset", 0ull);
+
+    for (const auto& [name, value] : doc["files"].items()) {
+        PackageManifestEntry entry;
+        entry.size = value.value("size", 0ull);
+        entry.mtime = value.value("mtime", 0ll);
+        entry.md5 = value.value("md5", "");
+        m_entries[name] = std::move(entry);
+    }
+
+    return true;
+}
+
+void PackageManifest::save(const std::string& path) const
+{
+    nlohmann::json files = nlohmann::json::object();
+
+    for (const auto& [name, entry] : m_entries) {
+        files[name] = {
+            {"size", entry.size},
+            {"mtime", entry.mtime},
+            {"md5", entry.md5}
+        };
+    }
+
+    nlohmann::json doc;
+    doc["version"] = MANIFEST_VERSION;
+    doc["archive"] = {
+        {"size", m_archive.size},
+        {"mtime", m_archive.mtime},
+        {"fileListOffset", m_archive.fileListOffset}
+    };
+    doc["files"] = std::move(files);
+
+    std::ofstream stream(path, std::ios::trunc);
+    if (!stream) {
+        throw Exception(std::format("Unable to write build manifest \"{}\".", path));
+    }
+
+    stream << doc.dump(1, '\t');
+}
+
+const PackageManifestEntry* PackageManifest::find(const std::string& name) const
+{
+    auto it = m_entries.find(name);
+    if (it == m_entries.end()) {
+        return nullptr;
+    }
+
+    return &it->second;
+}
+
+void PackageManifest::set(const std::string& name, PackageManifestEntry entry)
+{
+    m_entries[name] = std::move(entry);
+}
+
+void PackageManifest::clear()
+{
+    m_archive = {};
+    m_entries.clear();
+}
+
+const PackageManifestArchive& PackageManifest::archive() const
+{
+    return m_archive;
+}
+
+void PackageManifest::setArchive(const PackageManifestArchive& archive)
+{
+    m_archive = archive;
+}
+
+std::string PackageManifest::pathFor(const std::string& packagePath)
+{
+    return packagePath + ".build.json";
+}
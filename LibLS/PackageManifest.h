@@ -0,0 +1,42 @@
+#pragma once
+
+// Per-file build record used to detect inputs that are unchanged since the last build
+struct PackageManifestEntry
+{
+    uint64_t size{0};
+    int64_t mtime{0};
+    std::string md5; // hex digest of the uncompressed contents
+};
+
+// The package a manifest was written alongside. A package replaced or rebuilt without its manifest no
+// longer matches, and the manifest is ignored.
+struct PackageManifestArchive
+{
+    uint64_t size{0};
+    int64_t mtime{0};
+    uint64_t fileListOffset{0};
+};
+
+// Sidecar written next to a package (<package>.build.json) when it is built incrementally
+class PackageManifest
+{
+public:
+    PackageManifest() = default;
+    ~PackageManifest() = default;
+
+    bool load(const std::string& path);
+    void save(const std::string& path) const;
+
+    const PackageManifestEntry* find(const std::string& name) const;
+    void set(const std::string& name, PackageManifestEntry entry);
+    void clear();
+
+    const PackageManifestArchive& archive() const;
+    void setArchive(const PackageManifestArchive& archive);
+
+    static std::string pathFor(const std::string& packagePath);
+
+private:
+    PackageManifestArchive m_archive;
+    std::unordered_map<std::string, PackageManifestEntry> m_entries;
+};
@@ -0,0 +1,153 @@
+#include "pch.h"
+#include "PackageVFS.h"
+
+bool PackageVFS::mount(const char* filename, bool memoryMapped)
+{
+    PAKReader reader;
+    reader.setIndexCache(true);
+
+    if (!reader.read(filename, memoryMapped)) {
+        return false;
+    }
+
+    mount(std::move(reader));
+
+    return true;
+}
+
+void PackageVFS::mount(PAKReader&& reader)
+{
+    auto archive = static_cast<uint32_t>(m_archives.size());
+    m_archives.emplace_back(std::make_unique<PAKReader>(std::move(reader)));
+
+    const auto priority = priorityOf(archive);
+
+    for (const auto& file : m_archives.back()->files()) {
+        auto [it, inserted] = m_filemap.try_emplace(file.name, m_files.size());
+        if (inserted) {
+            m_files.push_back({archive, &file});
+            continue;
+        }
+
+        // Later archives override earlier ones unless the earlier one has a higher priority
+        auto& entry = m_files[it->second];
+        if (priority >= priorityOf(entry.archive)) {
+            entry = {archive, &file};
+        }
+    }
+}
+
+void PackageVFS::close()
+{
+    m_filemap.clear();
+    m_files.clear();
+    m_archives.clear();
+}
+
+size_t PackageVFS::archiveCount() const
+{
+    return m_archives.size();
+}
+
+const PAKReader& PackageVFS::archive(uint32_t index) const
+{
+    return *m_archives.at(index);
+}
+
+const std::vector<PackageVFS::Entry>& PackageVFS::files() const
+{
+    return m_files;
+}
+
+const PackageVFS::Entry* PackageVFS::find(const std::string& name) const
+{
+    auto it = m_filemap.find(name);
+    if (it != m_filemap.end()) {
+        return &m_files[it->second];
+    }
+
+    return nullptr;
+}
+
+void PackageVFS::sortFiles()
+{
+    std::ranges::sort(m_files, [](const Entry& a, const Entry& b) {
+        return a.file->name < b.file->name;
+    });
+
+    m_filemap.clear();
+
+    for (size_t i = 0; i < m_files.size(); ++i) {
+        m_filemap[m_files[i].file->name] = i;
+    }
+}
+
+ByteBuffer PackageVFS::readFile(const std::string& name) const
+{
+    return readFileData(name).detach();
+}
+
+PackagedFileData PackageVFS::readFileData(const std::string& name) const
+{
+    return readFileData(lookup(name));
+}
+
+PackagedFileData PackageVFS::readFileData(const Entry& entry) const
+{
+    return archive(entry.archive).readFileData(*entry.file);
+}
+
+size_t PackageVFS::scanFiles(const FileFilter& filter, const FileVisitor& visitor) const
+{
+    size_t visited = 0;
+    auto stopped = false;
+
+    for (const auto& archive : m_archives) {
+        // Skip the files this archive provides that are overridden elsewhere
+        auto effective = [&](const PackagedFileInfo& file) {
+            const auto* entry = find(file.name);
+            return entry != nullptr && entry->file == &file && (!filter || filter(file));
+        };
+
+        archive->scanFiles(effective, [&](size_t, const PackagedFileInfo& file, const PackagedFileData& contents) {
+            if (!visitor(visited++, file, contents)) {
+                stopped = true;
+                return false;
+            }
+
+            return true;
+        });
+
+        if (stopped) {
+            break;
+        }
+    }
+
+    return visited;
+}
+
+size_t PackageVFS::countFiles(const FileFilter& filter) const
+{
+    if (!filter) {
+        return m_files.size();
+    }
+
+    return std::ranges::count_if(m_files, [&](const Entry& entry) {
+        return filter(*entry.file);
+    });
+}
+
+const PackageVFS::Entry& PackageVFS::lookup(const std::string& name) const
+{
+    const auto* entry = find(name);
+    if (entry == nullptr) {
+        throw std::out_of_range("File not found.");
+    }
+
+    return *entry;
+}
+
+uint8_t PackageVFS::priorityOf(uint32_t archive) const
+{
+    return m_archives[archive]->package().m_header.priority;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "PAKReader.h"
+
+// Load-order overlay of several packages.
+// Each file name resolves to the entry from the archive with the highest priority;
+// among archives of equal priority, the one mounted last wins.
+class PackageVFS
+{
+public:
+    // Effective entry for a file name
+    struct Entry
+    {
+        uint32_t archive; // index of the mounted archive that provides the file
+        const PackagedFileInfo* file;
+
+        bool operator==(const Entry&) const = default;
+    };
+
+    struct EntryHash
+    {
+        size_t operator()(const Entry& entry) const noexcept
+        {
+            return std::hash<const void*>()(entry.file) ^ entry.archive;
+        }
+    };
+
+    using FileFilter = PAKReader::FileFilter;
+    using FileVisitor = PAKReader::FileVisitor;
+
+    PackageVFS() = default;
+    ~PackageVFS() = default;
+
+    PackageVFS(PackageVFS&&) noexcept = default;
+    PackageVFS& operator=(PackageVFS&&) noexcept = default;
+
+    PackageVFS(const PackageVFS&) = delete;
+    PackageVFS& operator=(const PackageVFS&) = delete;
+
+    // Mount archives in load order
+    bool mount(const char* filename, bool memoryMapped = false);
+    void mount(PAKReader&& reader);
+    void close();
+
+    size_t archiveCount() const;
+    const PAKReader& archive(uint32_t index) const;
+
+    const std::vector<Entry>& files() const;
+    const Entry* find(const std::string& name) const;
+    void sortFiles();
+
+    ByteBuffer readFile(const std::string& name) const;
+    PackagedFileData readFileData(const std::string& name) const;
+    PackagedFileData readFileData(const Entry& entry) const;
+
+    // Visits the effective entries archive by archive, in on-disk order within each archive
+    size_t scanFiles(const FileFilter& filter, const FileVisitor& visitor) const;
+    size_t countFiles(const FileFilter& filter = nullptr) const;
+
+private:
+    const Entry& lookup(const std::string& name) const;
+    uint8_t priorityOf(uint32_t archive) const;
+
+    std::vector<std::unique_ptr<PAKReader>> m_archives;
+    std::vector<Entry> m_files;
+
+    // Keys view the names owned by the mounted archives
+    std::unordered_map<std::string_view, size_t> m_filemap;
+};
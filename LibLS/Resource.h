@@ -14,6 +14,7 @@ struct Resource
     LSMetadata metadata{};
     LSFMetadataFormat metadataFormat{LSFMetadataFormat::NONE };
     std::unordered_map<std::string, Region::Ptr> regions;
+    std::vector<ByteBuffer> buffers; // decoded sections that string_view attribute values point into
 
     using Ptr = std::unique_ptr<Resource>;
 
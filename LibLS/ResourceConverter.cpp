@@ -0,0 +1,241 @@
+#include "pch.h"
+#include "FileStream.h"
+#include "LSFReader.h"
+#include "LSFWriter.h"
+#include "LSXReader.h"
+#include "PAKReader.h"
+#include "ProgressListener.h"
+#include "ResourceConverter.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <deque>
+#include <format>
+#include <map>
+#include <numeric>
+#include <set>
+
+namespace fs = std::filesystem;
+
+namespace { // anonymous namespace
+
+struct ConvertedFile
+{
+    uint64_t bytesRead{0};
+    uint64_t bytesWritten{0};
+    std::string error;
+};
+
+// One reader of each kind per worker thread, reused for every file it converts
+Resource::Ptr readResource(ResourceFormat format, const ByteBuffer& contents)
+{
+    if (format == LSX) {
+        thread_local LSXReader reader;
+        return reader.read(contents);
+    }
+
+    thread_local LSFReader reader;
+    reader.setParallel(false); // the batch already keeps every worker busy
+    reader.setZeroCopy(true);
+
+    return reader.read(contents);
+}
+
+fs::path outputName(const std::string& name)
+{
+    return fs::path(name).replace_extension(".lsf");
+}
+
+} // anonymous namespace
+
+ResourceConverter::ResourceConverter(uint32_t threads) : m_threads(threads)
+{
+}
+
+ResourceConversionResult ResourceConverter::convertDirectory(const char* source, const char* output,
+                                                             IFileProgressListener* listener) const
+{
+    const fs::path root(source);
+
+    std::vector<std::string> names;
+    ResourceFormat format;
+
+    for (const auto& entry : fs::recursive_directory_iterator(root)) {
+        if (entry.is_regular_file() && resourceFormat(entry.path().string(), format)) {
+            names.emplace_back(fs::relative(entry.path(), root).generic_string());
+        }
+    }
+
+    return convert(names, [&](size_t index) {
+        FileStream stream;
+        stream.open((root / names[index]).string().c_str(), "rb");
+        return stream.read();
+    }, output, listener);
+}
+
+ResourceConversionResult ResourceConverter::convertPackage(const PAKReader& reader, const char* output,
+                                                           IFileProgressListener* listener) const
+{
+    std::vector<const PackagedFileInfo*> files;
+    ResourceFormat format;
+
+    for (const auto& file : reader.files()) {
+        if (resourceFormat(file.name, format)) {
+            files.push_back(&file);
+        }
+    }
+
+    std::vector<std::string> names;
+    names.reserve(files.size());
+    for (const auto* file : files) {
+        names.push_back(file->name);
+    }
+
+    // Package reads are positional and may be issued from every worker at once
+    return convert(names, [&](size_t index) {
+        return reader.readFile(*files[index]);
+    }, output, listener);
+}
+
+bool ResourceConverter::resourceFormat(const std::string& name, ResourceFormat& format)
+{
+    auto ext = fs::path(name).extension().string();
+    std::ranges::transform(ext, ext.begin(), ::tolower);
+
+    if (ext == ".lsx") {
+        format = LSX;
+        return true;
+    }
+
+    if (ext == ".lsf") {
+        format = LSF;
+        return true;
+    }
+
+    return false;
+}
+
+ResourceConversionResult ResourceConverter::convert(const std::vector<std::string>& names, const Loader& load,
+                                                    const fs::path& output, IFileProgressListener* listener) const
+{
+    ResourceConversionResult result;
+
+    // Visit in name order, and where an LSX and an LSF file would produce the same output, convert only
+    // the first of them (the LSF file) and report the other as skipped
+    std::vector<size_t> order(names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::ranges::sort(order, [&](size_t a, size_t b) {
+        return names[a] < names[b];
+    });
+
+    std::map<fs::path, size_t> outputs;
+    std::set<fs::path> directories;
+    std::vector<size_t> indices;
+    indices.reserve(order.size());
+
+    for (auto index : order) {
+        auto path = output / outputName(names[index]);
+        auto [it, inserted] = outputs.emplace(path, index);
+        if (inserted) {
+            directories.insert(path.parent_path());
+            indices.push_back(index);
+        } else {
+            result.errors.push_back({names[index], std::format("Skipped: same output as \"{}\".", names[it->second])});
+        }
+    }
+
+    // Create the directory tree up front so workers never contend on it
+    for (const auto& directory : directories) {
+        create_directories(directory);
+    }
+
+    if (listener) {
+        listener->onStart(indices.size());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    ThreadPool pool(m_threads);
+
+    // Each task reads its input only when it runs, so this bounds the files held in memory at once
+    const size_t maxInFlight = pool.size() * 2;
+
+    std::deque<std::pair<size_t, std::future<ConvertedFile>>> pending;
+    size_t retired = 0;
+
+    auto retire = [&] {
+        auto& [index, future] = pending.front();
+        auto converted = future.get();
+
+        result.bytesRead += converted.bytesRead;
+        result.bytesWritten += converted.bytesWritten;
+
+        if (converted.error.empty()) {
+            ++result.files;
+        } else {
+            result.errors.push_back({names[index], std::move(converted.error)});
+        }
+
+        if (listener) {
+            listener->onFile(retired, names[index]);
+        }
+
+        ++retired;
+        pending.pop_front();
+    };
+
+    for (auto index : indices) {
+        if (listener && listener->isCancelled()) {
+            result.cancelled = true;
+            break;
+        }
+
+        if (pending.size() >= maxInFlight) {
+            retire();
+        }
+
+        pending.emplace_back(index, pool.submit([&, index] {
+            ConvertedFile converted;
+
+            try {
+                ResourceFormat format{};
+                resourceFormat(names[index], format);
+
+                auto contents = load(index);
+                converted.bytesRead = contents.second;
+
+                auto resource = readResource(format, contents);
+                contents = {}; // the resource no longer needs the input
+
+                FileStream stream;
+                stream.open((output / outputName(names[index])).string().c_str(), "wb");
+
+                LSFWriter writer;
+                writer.write(stream, *resource);
+
+                converted.bytesWritten = stream.tell();
+            } catch (const std::exception& e) {
+                converted.error = e.what();
+            }
+
+            return converted;
+        }));
+    }
+
+    while (!pending.empty()) {
+        retire();
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+
+    if (listener) {
+        if (result.cancelled) {
+            listener->onCancel();
+        } else {
+            listener->onFinished(indices.size());
+        }
+    }
+
+    return result;
+}
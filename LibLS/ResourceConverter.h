@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Resource.h"
+
+class IFileProgressListener;
+class PAKReader;
+
+struct ResourceConversionError
+{
+    std::string name;
+    std::string message;
+};
+
+// Totals of a batch conversion; rates are over the wall-clock time of the whole batch
+struct ResourceConversionResult
+{
+    size_t files{0}; // files converted
+    uint64_t bytesRead{0};
+    uint64_t bytesWritten{0};
+    double seconds{0};
+    std::vector<ResourceConversionError> errors; // failed, or skipped because another input has the same output
+    bool cancelled{false};
+
+    double filesPerSecond() const
+    {
+        return seconds > 0 ? static_cast<double>(files) / seconds : 0.0;
+    }
+
+    double megabytesPerSecond() const
+    {
+        return seconds > 0 ? static_cast<double>(bytesRead) / (1024 * 1024) / seconds : 0.0;
+    }
+
+    bool ok() const
+    {
+        return !cancelled && errors.empty();
+    }
+};
+
+// Converts the LSX and LSF resources of a directory tree or a package to LSF files beneath an output
+// directory, keeping their relative paths. LSX files are parsed and written as LSF; LSF files are
+// re-encoded by the current writer, which stores them uncompressed. Other files are ignored.
+// Conversion only runs towards LSF; the library has no LSX writer, so LSF to LSX is not offered.
+// Each worker thread keeps its own readers, and at most two files per worker are in flight at once,
+// so memory stays bounded whatever the size of the input.
+class ResourceConverter
+{
+public:
+    // A thread count of zero uses one worker per hardware thread
+    explicit ResourceConverter(uint32_t threads = 0);
+
+    // Progress is reported in name order from the calling thread
+    ResourceConversionResult convertDirectory(const char* source, const char* output,
+                                              IFileProgressListener* listener = nullptr) const;
+    ResourceConversionResult convertPackage(const PAKReader& reader, const char* output,
+                                            IFileProgressListener* listener = nullptr) const;
+
+    // The format of a resource by its extension, ignoring case; false when it is not one
+    static bool resourceFormat(const std::string& name, ResourceFormat& format);
+
+private:
+    using Loader = std::function<ByteBuffer(size_t index)>;
+
+    ResourceConversionResult convert(const std::vector<std::string>& names, const Loader& load,
+                                     const std::filesystem::path& output, IFileProgressListener* listener) const;
+
+    uint32_t m_threads;
+};
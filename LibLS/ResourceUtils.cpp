@@ -3,6 +3,7 @@
 
 #include "Exception.h"
 #include "FileStream.h"
+#include "LSFReader.h"
 #include "LSFWriter.h"
 #include "LSXReader.h"
 
@@ -21,7 +22,7 @@ Resource::Ptr ResourceUtils::loadResource(const char* filename, ResourceFormat f
         return reader.read(buffer);
     }
     case LSF: {
-        LSXReader reader;
+        LSFReader reader;
         return reader.read(buffer);
     }
 
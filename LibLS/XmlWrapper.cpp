@@ -7,7 +7,12 @@ XmlWrapper::XmlWrapper()
 
 XmlWrapper::XmlWrapper(const ByteBuffer& buffer)
 {
-    load(buffer);
+    load(buffer.first.get(), buffer.second);
+}
+
+XmlWrapper::XmlWrapper(const uint8_t* data, size_t size)
+{
+    load(data, size);
 }
 
 XmlWrapper::XmlWrapper(const XmlWrapper& rhs)
@@ -53,19 +58,19 @@ pugi::xpath_node_set XmlWrapper::selectNodes(const char* xpath) const
     return m_doc.select_nodes(xpath);
 }
 
-void XmlWrapper::load(const ByteBuffer& buffer)
+void XmlWrapper::load(const uint8_t* data, size_t size)
 {
-    // Convert buffer to string
-    std::string xml(buffer.first.get(), buffer.first.get() + buffer.second);
+    std::string_view xml(reinterpret_cast<const char*>(data), size);
 
     // Strip UTF-8 BOM if present
-    static const std::string UTF8_BOM = "\xEF\xBB\xBF";
+    static constexpr std::string_view UTF8_BOM = "\xEF\xBB\xBF";
     if (xml.starts_with(UTF8_BOM)) {
-        xml.erase(0, UTF8_BOM.size());
+        xml.remove_prefix(UTF8_BOM.size());
     }
 
-    // Parse the XML document
-    pugi::xml_parse_result result = m_doc.load_string(xml.c_str());
+    // Parse the XML document; pugixml copies the buffer, so the caller's memory may be a view
+    pugi::xml_parse_result result = m_doc.load_buffer(xml.data(), xml.size(), pugi::parse_default,
+                                                      pugi::encoding_utf8);
     if (!result) {
         throw Exception("Failed to parse XML document.");
     }
@@ -7,6 +7,7 @@ class XmlWrapper
 public:
     XmlWrapper();
     explicit XmlWrapper(const ByteBuffer& buffer);
+    XmlWrapper(const uint8_t* data, size_t size);
     XmlWrapper(const XmlWrapper& rhs);
     explicit XmlWrapper(const pugi::xml_document& doc);
     ~XmlWrapper();
@@ -19,7 +20,7 @@ public:
     pugi::xpath_node_set selectNodes(const char* xpath) const;
 
 private:
-    void load(const ByteBuffer& buffer);
+    void load(const uint8_t* data, size_t size);
 
     pugi::xml_document m_doc;
 };
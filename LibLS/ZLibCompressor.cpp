@@ -12,29 +12,33 @@ Stream ZLibCompressor::compress(StreamBase& input, LSCompressionLevel level)
     return compress(data.first.get(), size, level);
 }
 
-Stream ZLibCompressor::compress(const uint8_t* data, size_t size, LSCompressionLevel level)
-{
-    auto zlibLevel = Z_DEFAULT_COMPRESSION;
+namespace { // anonymous namespace
 
+constexpr auto ZLIB_CHUNK_SIZE = 256 * 1024u;
+
+int zlibLevel(LSCompressionLevel level)
+{
     switch (level) {
     case LSCompressionLevel::FAST:
-        zlibLevel = Z_BEST_SPEED;
-        break;
-    case LSCompressionLevel::DEFAULT:
-        zlibLevel = Z_DEFAULT_COMPRESSION;
-        break;
+        return Z_BEST_SPEED;
     case LSCompressionLevel::MAX:
-        zlibLevel = Z_BEST_COMPRESSION;
-        break;
+        return Z_BEST_COMPRESSION;
+    default:
+        return Z_DEFAULT_COMPRESSION;
     }
+}
+
+} // anonymous namespace
 
+Stream ZLibCompressor::compress(const uint8_t* data, size_t size, LSCompressionLevel level)
+{
     auto maxCompressedSize = compressBound(static_cast<uLong>(size));
 
     auto compressedData = std::make_unique<uint8_t[]>(maxCompressedSize);
 
     auto result = compress2(reinterpret_cast<Bytef*>(compressedData.get()), &maxCompressedSize,
                             reinterpret_cast<const Bytef*>(data), static_cast<uLong>(size),
-                            zlibLevel);
+                            zlibLevel(level));
     if (result != Z_OK) {
         auto* errMsg = "Unknown error";
         switch (result) {
@@ -56,19 +60,68 @@ Stream ZLibCompressor::compress(const uint8_t* data, size_t size, LSCompressionL
     return Stream({std::move(compressedData), maxCompressedSize});
 }
 
+size_t ZLibCompressor::compress(const Compression::ChunkReader& reader, const Compression::ChunkWriter& writer,
+                                LSCompressionLevel level)
+{
+    z_stream strm{};
+    auto result = deflateInit(&strm, zlibLevel(level));
+    if (result != Z_OK) {
+        throw Exception(std::format("ZLib compression failed ({}): deflateInit", result));
+    }
+
+    std::unique_ptr<z_stream, decltype(&deflateEnd)> guard(&strm, deflateEnd);
+
+    auto inBuf = std::make_unique<uint8_t[]>(ZLIB_CHUNK_SIZE);
+    auto outBuf = std::make_unique<uint8_t[]>(ZLIB_CHUNK_SIZE);
+
+    size_t compressedSize = 0;
+    auto flush = Z_NO_FLUSH;
+
+    while (flush != Z_FINISH) {
+        auto read = reader(inBuf.get(), ZLIB_CHUNK_SIZE);
+        flush = read < ZLIB_CHUNK_SIZE ? Z_FINISH : Z_NO_FLUSH;
+
+        strm.next_in = reinterpret_cast<Bytef*>(inBuf.get());
+        strm.avail_in = static_cast<uInt>(read);
+
+        do {
+            strm.next_out = reinterpret_cast<Bytef*>(outBuf.get());
+            strm.avail_out = ZLIB_CHUNK_SIZE;
+
+            result = deflate(&strm, flush);
+            if (result == Z_STREAM_ERROR) {
+                throw Exception(std::format("ZLib compression failed ({}): Z_STREAM_ERROR", result));
+            }
+
+            auto produced = ZLIB_CHUNK_SIZE - strm.avail_out;
+            writer(outBuf.get(), produced);
+            compressedSize += produced;
+        } while (strm.avail_out == 0);
+    }
+
+    return compressedSize;
+}
+
 Stream ZLibCompressor::decompress(StreamBase& input, size_t uncompressedSize, bool chunked)
 {
     auto data = Stream::makeStream(input).detach();
     return decompress(data.first.get(), data.second, uncompressedSize, chunked);
 }
 
-Stream ZLibCompressor::decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool /*chunked*/)
+Stream ZLibCompressor::decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool chunked)
 {
     auto uncompressedData = std::make_unique<uint8_t[]>(uncompressedSize);
 
-    auto destLen = static_cast<uLongf>(uncompressedSize);
+    auto decompressedSize = decompress(data, size, {uncompressedData.get(), uncompressedSize}, chunked);
+
+    return Stream({std::move(uncompressedData), decompressedSize});
+}
+
+size_t ZLibCompressor::decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, bool /*chunked*/)
+{
+    auto destLen = static_cast<uLongf>(output.size());
 
-    auto result = uncompress(reinterpret_cast<Bytef*>(uncompressedData.get()), &destLen,
+    auto result = uncompress(reinterpret_cast<Bytef*>(output.data()), &destLen,
                              reinterpret_cast<const Bytef*>(data), static_cast<uLong>(size));
 
     if (result != Z_OK) {
@@ -88,5 +141,5 @@ Stream ZLibCompressor::decompress(const uint8_t* data, size_t size, size_t uncom
         throw Exception(std::format("ZLib decompression failed ({}): {}", result, errMsg));
     }
 
-    return Stream({std::move(uncompressedData), destLen});
+    return destLen;
 }
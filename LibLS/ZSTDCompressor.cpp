@@ -5,6 +5,8 @@
 
 #include "Exception.h"
 
+ZSTDCompressor::~ZSTDCompressor() = default;
+
 Stream ZSTDCompressor::compress(StreamBase& input, LSCompressionLevel level)
 {
     auto size = input.size();
@@ -14,28 +16,12 @@ Stream ZSTDCompressor::compress(StreamBase& input, LSCompressionLevel level)
 
 Stream ZSTDCompressor::compress(const uint8_t* data, size_t size, LSCompressionLevel level)
 {
-    Stream output;
-
-    auto zstdLevel = 0;
-
-    switch (level) {
-    case LSCompressionLevel::FAST:
-        zstdLevel = 1;
-        break;
-    case LSCompressionLevel::DEFAULT:
-        zstdLevel = 3;
-        break;
-    case LSCompressionLevel::MAX:
-        zstdLevel = 12;
-        break;
-    }
-
     auto maxCompressedSize = ZSTD_compressBound(size);
 
     auto compressedData = std::make_unique<uint8_t[]>(maxCompressedSize);
 
-    auto compressedSize = ZSTD_compress(compressedData.get(), maxCompressedSize,
-                                        data, size, zstdLevel);
+    auto compressedSize = ZSTD_compressCCtx(compressionContext(), compressedData.get(), maxCompressedSize,
+                                            data, size, compressionLevel(level));
 
     if (ZSTD_isError(compressedSize)) {
         throw Exception(std::format("ZSTD compression failed: {}", ZSTD_getErrorName(compressedSize)));
@@ -44,6 +30,50 @@ Stream ZSTDCompressor::compress(const uint8_t* data, size_t size, LSCompressionL
     return Stream({std::move(compressedData), compressedSize});
 }
 
+size_t ZSTDCompressor::compress(const Compression::ChunkReader& reader, const Compression::ChunkWriter& writer,
+                                LSCompressionLevel level)
+{
+    auto* cctx = compressionContext();
+
+    ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, compressionLevel(level));
+
+    auto inSize = ZSTD_CStreamInSize();
+    auto outSize = ZSTD_CStreamOutSize();
+    auto inBuf = std::make_unique<uint8_t[]>(inSize);
+    auto outBuf = std::make_unique<uint8_t[]>(outSize);
+
+    size_t compressedSize = 0;
+
+    for (;;) {
+        auto read = reader(inBuf.get(), inSize);
+        auto mode = read < inSize ? ZSTD_e_end : ZSTD_e_continue;
+
+        ZSTD_inBuffer input{inBuf.get(), read, 0};
+
+        auto finished = false;
+        while (!finished) {
+            ZSTD_outBuffer output{outBuf.get(), outSize, 0};
+
+            auto remaining = ZSTD_compressStream2(cctx, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                throw Exception(std::format("ZSTD compression failed: {}", ZSTD_getErrorName(remaining)));
+            }
+
+            writer(outBuf.get(), output.pos);
+            compressedSize += output.pos;
+
+            finished = mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size;
+        }
+
+        if (mode == ZSTD_e_end) {
+            break;
+        }
+    }
+
+    return compressedSize;
+}
+
 Stream ZSTDCompressor::decompress(StreamBase& input, size_t uncompressedSize, bool chunked)
 {
     auto data = Stream::makeStream(input).detach();
@@ -51,14 +81,95 @@ Stream ZSTDCompressor::decompress(StreamBase& input, size_t uncompressedSize, bo
     return decompress(data.first.get(), data.second, uncompressedSize, chunked);
 }
 
-Stream ZSTDCompressor::decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool /*chunked*/)
+Stream ZSTDCompressor::decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool chunked)
 {
     auto uncompressedData = std::make_unique<uint8_t[]>(uncompressedSize);
 
-    auto result = ZSTD_decompress(uncompressedData.get(), uncompressedSize, data, size);
+    auto decompressedSize = decompress(data, size, {uncompressedData.get(), uncompressedSize}, chunked);
+
+    return Stream({std::move(uncompressedData), decompressedSize});
+}
+
+size_t ZSTDCompressor::decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, bool /*chunked*/)
+{
+    auto result = ZSTD_decompressDCtx(decompressionContext(), output.data(), output.size(), data, size);
+    if (ZSTD_isError(result)) {
+        throw Exception(std::format("ZSTD decompression failed: {}", ZSTD_getErrorName(result)));
+    }
+
+    return result;
+}
+
+Stream ZSTDCompressor::compress(const uint8_t* data, size_t size, const ZSTDDictionary& dictionary)
+{
+    auto maxCompressedSize = ZSTD_compressBound(size);
+
+    auto compressedData = std::make_unique<uint8_t[]>(maxCompressedSize);
+
+    auto compressedSize = ZSTD_compress_usingCDict(compressionContext(), compressedData.get(), maxCompressedSize,
+                                                   data, size, dictionary.compressionDictionary());
+
+    if (ZSTD_isError(compressedSize)) {
+        throw Exception(std::format("ZSTD compression failed: {}", ZSTD_getErrorName(compressedSize)));
+    }
+
+    return Stream({std::move(compressedData), compressedSize});
+}
+
+size_t ZSTDCompressor::decompress(const uint8_t* data, size_t size, std::span<uint8_t> output,
+                                  const ZSTDDictionary& dictionary)
+{
+    auto result = ZSTD_decompress_usingDDict(decompressionContext(), output.data(), output.size(), data, size,
+                                             dictionary.decompressionDictionary());
     if (ZSTD_isError(result)) {
         throw Exception(std::format("ZSTD decompression failed: {}", ZSTD_getErrorName(result)));
     }
 
-    return Stream({std::move(uncompressedData), result});
+    return result;
+}
+
+int ZSTDCompressor::compressionLevel(LSCompressionLevel level)
+{
+    switch (level) {
+    case LSCompressionLevel::FAST:
+        return 1;
+    case LSCompressionLevel::MAX:
+        return 12;
+    default:
+        return 3;
+    }
+}
+
+ZSTD_CCtx* ZSTDCompressor::compressionContext()
+{
+    if (m_cctx == nullptr) {
+        m_cctx.reset(ZSTD_createCCtx());
+        if (m_cctx == nullptr) {
+            throw Exception("Failed to create ZSTD compression context");
+        }
+    }
+
+    return m_cctx.get();
+}
+
+ZSTD_DCtx* ZSTDCompressor::decompressionContext()
+{
+    if (m_dctx == nullptr) {
+        m_dctx.reset(ZSTD_createDCtx());
+        if (m_dctx == nullptr) {
+            throw Exception("Failed to create ZSTD decompression context");
+        }
+    }
+
+    return m_dctx.get();
+}
+
+void ZSTDCompressor::ContextDeleter::operator()(ZSTD_CCtx* cctx) const
+{
+    ZSTD_freeCCtx(cctx);
+}
+
+void ZSTDCompressor::ContextDeleter::operator()(ZSTD_DCtx* dctx) const
+{
+    ZSTD_freeDCtx(dctx);
 }
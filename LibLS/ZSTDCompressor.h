@@ -1,14 +1,40 @@
 #pragma once
 #include "ICompressor.h"
+#include "ZSTDDictionary.h"
+
+struct ZSTD_CCtx_s;
+struct ZSTD_DCtx_s;
 
 class ZSTDCompressor : public ICompressor
 {
 public:
     ZSTDCompressor() = default;
-    ~ZSTDCompressor() override = default;
+    ~ZSTDCompressor() override;
 
     Stream compress(StreamBase& input, LSCompressionLevel level) override;
     Stream compress(const uint8_t* data, size_t size, LSCompressionLevel level) override;
+    size_t compress(const Compression::ChunkReader& reader, const Compression::ChunkWriter& writer,
+                    LSCompressionLevel level) override;
     Stream decompress(StreamBase& input, size_t uncompressedSize, bool chunked = false) override;
     Stream decompress(const uint8_t* data, size_t size, size_t uncompressedSize, bool chunked = false) override;
+    size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, bool chunked = false) override;
+
+    Stream compress(const uint8_t* data, size_t size, const ZSTDDictionary& dictionary);
+    size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output, const ZSTDDictionary& dictionary);
+
+    static int compressionLevel(LSCompressionLevel level);
+
+private:
+    ZSTD_CCtx_s* compressionContext();
+    ZSTD_DCtx_s* decompressionContext();
+
+    struct ContextDeleter
+    {
+        void operator()(ZSTD_CCtx_s* cctx) const;
+        void operator()(ZSTD_DCtx_s* dctx) const;
+    };
+
+    // Created on first use and reused by every later call on this instance
+    std::unique_ptr<ZSTD_CCtx_s, ContextDeleter> m_cctx;
+    std::unique_ptr<ZSTD_DCtx_s, ContextDeleter> m_dctx;
 };
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "Exception.h"
+#include "ZSTDCompressor.h"
+#include "ZSTDDictionary.h"
+
+#include <zdict.h>
+#include <zstd.h>
+
+ZSTDDictionary::ZSTDDictionary(ByteBuffer contents, LSCompressionLevel level)
+    : m_contents(std::move(contents)), m_level(level)
+{
+}
+
+ZSTDDictionary::~ZSTDDictionary()
+{
+    ZSTD_freeCDict(m_cdict);
+    ZSTD_freeDDict(m_ddict);
+}
+
+std::unique_ptr<ZSTDDictionary> ZSTDDictionary::train(const std::vector<ByteBuffer>& samples, size_t capacity,
+                                                      LSCompressionLevel level)
+{
+    size_t total = 0;
+    for (const auto& sample : samples) {
+        total += sample.second;
+    }
+
+    // The trainer takes the samples end to end along with their sizes
+    auto buffer = std::make_unique<uint8_t[]>(total);
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+
+    size_t offset = 0;
+    for (const auto& [data, size] : samples) {
+        memcpy(buffer.get() + offset, data.get(), size);
+        offset += size;
+        sizes.push_back(size);
+    }
+
+    auto contents = std::make_unique<uint8_t[]>(capacity);
+
+    auto size = ZDICT_trainFromBuffer(contents.get(), capacity, buffer.get(), sizes.data(),
+                                      static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        return nullptr;
+    }
+
+    return std::make_unique<ZSTDDictionary>(ByteBuffer{std::move(contents), size}, level);
+}
+
+const uint8_t* ZSTDDictionary::data() const
+{
+    return m_contents.first.get();
+}
+
+size_t ZSTDDictionary::size() const
+{
+    return m_contents.second;
+}
+
+const ZSTD_CDict* ZSTDDictionary::compressionDictionary() const
+{
+    std::call_once(m_cdictCreated, [this] {
+        m_cdict = ZSTD_createCDict(data(), size(), ZSTDCompressor::compressionLevel(m_level));
+    });
+
+    if (m_cdict == nullptr) {
+        throw Exception("Failed to create ZSTD compression dictionary");
+    }
+
+    return m_cdict;
+}
+
+const ZSTD_DDict* ZSTDDictionary::decompressionDictionary() const
+{
+    std::call_once(m_ddictCreated, [this] {
+        m_ddict = ZSTD_createDDict(data(), size());
+    });
+
+    if (m_ddict == nullptr) {
+        throw Exception("Failed to create ZSTD decompression dictionary");
+    }
+
+    return m_ddict;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Compress.h"
+
+#include <mutex>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+// ZSTD dictionary shared by every entry of an archive, so that many small, similar files
+// can reference each other's common content instead of each starting from scratch.
+class ZSTDDictionary
+{
+public:
+    ZSTDDictionary(ByteBuffer contents, LSCompressionLevel level = LSCompressionLevel::DEFAULT);
+    ~ZSTDDictionary();
+
+    ZSTDDictionary(const ZSTDDictionary&) = delete;
+    ZSTDDictionary& operator=(const ZSTDDictionary&) = delete;
+
+    // Trains a dictionary of at most capacity bytes; returns nullptr when the samples give too little to train on
+    static std::unique_ptr<ZSTDDictionary> train(const std::vector<ByteBuffer>& samples, size_t capacity,
+                                                 LSCompressionLevel level);
+
+    const uint8_t* data() const;
+    size_t size() const;
+
+    // Digested forms are built on first use; a reader never needs the compression one
+    const ZSTD_CDict_s* compressionDictionary() const;
+    const ZSTD_DDict_s* decompressionDictionary() const;
+
+private:
+    ByteBuffer m_contents;
+    LSCompressionLevel m_level;
+
+    mutable std::once_flag m_cdictCreated, m_ddictCreated;
+    mutable ZSTD_CDict_s* m_cdict{nullptr};
+    mutable ZSTD_DDict_s* m_ddict{nullptr};
+};
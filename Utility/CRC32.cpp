@@ -1,9 +1,11 @@
 #include "pch.h"
 #include "CRC32.h"
 
+#include <array>
+
 namespace { // anonymous
 
-constexpr uint32_t table[256] = {
+constexpr uint32_t table0[256] = {
     0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
     0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
     0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
@@ -48,15 +50,54 @@ constexpr uint32_t table[256] = {
     0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
     0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
 };
+
+// Slice-by-8 tables: tables[k][b] is the CRC of byte b followed by k zero bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> makeTables()
+{
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+
+    for (auto i = 0; i < 256; ++i) {
+        tables[0][i] = table0[i];
+    }
+
+    for (auto k = 1; k < 8; ++k) {
+        for (auto i = 0; i < 256; ++i) {
+            tables[k][i] = tables[k - 1][i] >> 8 ^ table0[tables[k - 1][i] & 0xFF];
+        }
+    }
+
+    return tables;
+}
+
+constexpr auto tables = makeTables();
+
 } // anonymous
 
 
 uint32_t CRC32::compute(const uint8_t* data, size_t length)
 {
-    uint32_t crc = 0xFFFFFFFF;
+    return update(0, data, length);
+}
+
+uint32_t CRC32::update(uint32_t crc, const uint8_t* data, size_t length)
+{
+    crc ^= 0xFFFFFFFF;
+
+    // Eight bytes per step; the input is read as little-endian words, as on every target we build for
+    for (; length >= 8; data += 8, length -= 8) {
+        uint32_t lo, hi;
+        memcpy(&lo, data, 4);
+        memcpy(&hi, data + 4, 4);
+        lo ^= crc;
+
+        crc = tables[7][lo & 0xFF] ^ tables[6][lo >> 8 & 0xFF] ^
+              tables[5][lo >> 16 & 0xFF] ^ tables[4][lo >> 24] ^
+              tables[3][hi & 0xFF] ^ tables[2][hi >> 8 & 0xFF] ^
+              tables[1][hi >> 16 & 0xFF] ^ tables[0][hi >> 24];
+    }
 
-    for (auto i = 0ul; i < length; i++) {
-        crc = table[(crc ^ data[i]) & 0xFF] ^ crc >> 8;
+    for (; length > 0; ++data, --length) {
+        crc = tables[0][(crc ^ *data) & 0xFF] ^ crc >> 8;
     }
 
     return crc ^ 0xFFFFFFFF;
@@ -4,4 +4,7 @@ class CRC32
 {
 public:
     static uint32_t compute(const uint8_t* data, size_t length);
+
+    // Extends a checksum returned by compute or update; update(0, ...) is equivalent to compute
+    static uint32_t update(uint32_t crc, const uint8_t* data, size_t length);
 };
@@ -233,6 +233,13 @@ void FileStream::seek(int64_t offset, SeekMode mode)
 
     flush();
 
+    // The handle's file pointer is wherever the last positional read left it, so resolve a relative
+    // seek against the logical position
+    if (mode == SeekMode::Current) {
+        offset += static_cast<int64_t>(curPos);
+        mode = SeekMode::Begin;
+    }
+
     LARGE_INTEGER li{}, pos{};
     li.QuadPart = offset;
 
@@ -281,6 +288,44 @@ Stream FileStream::read(size_t bytes)
     return {buf.get(), bytes};
 }
 
+size_t FileStream::readAt(uint64_t offset, void* buf, size_t size) const
+{
+    if (!(m_access & GENERIC_READ)) {
+        throw Exception("Stream not opened for reading.");
+    }
+
+    auto* pbuf = static_cast<uint8_t*>(buf);
+    size_t totalRead = 0;
+
+    while (size > 0) {
+        OVERLAPPED ov{};
+        ov.Offset = static_cast<DWORD>(offset & 0xFFFFFFFF);
+        ov.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        auto chunk = static_cast<DWORD>(std::min<size_t>(size, MAXDWORD));
+
+        DWORD read = 0;
+        if (!ReadFile(m_file, pbuf, chunk, &read, &ov)) {
+            auto error = GetLastError();
+            if (error == ERROR_HANDLE_EOF) {
+                break;
+            }
+            throw Exception(error);
+        }
+
+        if (read == 0) {
+            break; // EOF
+        }
+
+        pbuf += read;
+        offset += read;
+        size -= read;
+        totalRead += read;
+    }
+
+    return totalRead;
+}
+
 bool FileStream::isOpen() const
 {
     return m_file != INVALID_HANDLE_VALUE;
@@ -305,13 +350,19 @@ bool FileStream::flush()
 
 bool FileStream::readBlock()
 {
-    LARGE_INTEGER pos{};
-    if (!SetFilePointerEx(m_file, {}, &pos, FILE_CURRENT)) {
-        throw Exception(GetLastError());
-    }
+    // Read at the logical position rather than the handle's file pointer,
+    // which positional reads (readAt) are free to move
+    auto pos = tell();
+
+    OVERLAPPED ov{};
+    ov.Offset = static_cast<DWORD>(pos & 0xFFFFFFFF);
+    ov.OffsetHigh = static_cast<DWORD>(pos >> 32);
 
     ULONG read;
-    if (!ReadFile(m_file, m_buf.get(), m_blockSize, &read, nullptr)) {
+    if (!ReadFile(m_file, m_buf.get(), m_blockSize, &read, &ov)) {
+        if (GetLastError() == ERROR_HANDLE_EOF) {
+            return true; // EOF
+        }
         return FALSE;
     }
 
@@ -321,7 +372,7 @@ bool FileStream::readBlock()
 
     m_pbuf = m_buf.get();
     m_nRemaining = read;
-    m_fileBase = pos.QuadPart;
+    m_fileBase = pos;
 
     return TRUE;
 }
@@ -366,9 +417,3 @@ void FileStream::alloc()
     memset(m_pbuf, 0, m_blockSize);
     m_nRemaining = 0;
 }
-
-uint64_t FileStream::logicalPos() const
-{
-    auto offset = m_pbuf - m_buf.get();
-    return m_fileBase + offset;
-}
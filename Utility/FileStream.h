@@ -32,13 +32,15 @@ public:
     Stream read(size_t bytes);
     void write(StreamBase& stream);
 
+    // Positional read that bypasses the stream buffer and position; safe to call concurrently
+    size_t readAt(uint64_t offset, void* buf, size_t size) const;
+
     bool isOpen() const;
     bool flush();
 
 private:
     bool readBlock();
     bool writeBlock();
-    uint64_t logicalPos() const;
     void alloc();
     
     HANDLE m_file; // file handle
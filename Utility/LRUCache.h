@@ -0,0 +1,131 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Least-recently-used cache bounded by the total byte size of its values.
+// Values are shared so callers keep them alive after they have been evicted.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class LRUCache
+{
+public:
+    using ValuePtr = std::shared_ptr<const V>;
+
+    explicit LRUCache(size_t capacity) : m_capacity(capacity)
+    {
+    }
+
+    LRUCache(const LRUCache&) = delete;
+    LRUCache& operator=(const LRUCache&) = delete;
+
+    ValuePtr get(const K& key)
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto it = m_map.find(key);
+        if (it == m_map.end()) {
+            ++m_misses;
+            return nullptr;
+        }
+
+        ++m_hits;
+        m_items.splice(m_items.begin(), m_items, it->second);
+
+        return it->second->value;
+    }
+
+    void put(const K& key, ValuePtr value, size_t size)
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto it = m_map.find(key);
+        if (it != m_map.end()) {
+            m_size -= it->second->size;
+            m_items.erase(it->second);
+            m_map.erase(it);
+        }
+
+        if (size > m_capacity) {
+            return; // would evict everything else and still not fit
+        }
+
+        m_items.push_front({key, std::move(value), size});
+        m_map[key] = m_items.begin();
+        m_size += size;
+
+        while (m_size > m_capacity) {
+            const auto& last = m_items.back();
+            m_size -= last.size;
+            m_map.erase(last.key);
+            m_items.pop_back();
+        }
+    }
+
+    // Returns the cached value or caches the one produced by load(), which yields {value, size}
+    template <typename F>
+    ValuePtr getOrLoad(const K& key, F&& load)
+    {
+        if (auto value = get(key)) {
+            return value;
+        }
+
+        auto [value, size] = load();
+        put(key, value, size);
+
+        return value;
+    }
+
+    void clear()
+    {
+        std::lock_guard lock(m_mutex);
+        m_items.clear();
+        m_map.clear();
+        m_size = 0;
+    }
+
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_size;
+    }
+
+    size_t count() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_items.size();
+    }
+
+    size_t hits() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_hits;
+    }
+
+    size_t misses() const
+    {
+        std::lock_guard lock(m_mutex);
+        return m_misses;
+    }
+
+private:
+    struct Item
+    {
+        K key;
+        ValuePtr value;
+        size_t size;
+    };
+
+    std::list<Item> m_items; // most recently used first
+    std::unordered_map<K, typename std::list<Item>::iterator, Hash> m_map;
+    size_t m_capacity;
+    size_t m_size = 0;
+    size_t m_hits = 0;
+    size_t m_misses = 0;
+    mutable std::mutex m_mutex;
+};
@@ -3,6 +3,7 @@
 #include "LZ4Codec.h"
 
 #include <lz4.h>
+#include <lz4hc.h>
 
 Stream LZ4Codec::encode(StreamBase& input, uint32_t inputOffset, size_t inputSize)
 {
@@ -28,6 +29,22 @@ Stream LZ4Codec::encode(const uint8_t* data, size_t size)
     return Stream::makeStream(std::move(output), result);
 }
 
+// Slower to encode than encode(), but the output decodes with the same LZ4_decompress_safe
+Stream LZ4Codec::encodeHC(const uint8_t* data, size_t size, int level)
+{
+    auto outputSize = LZ4_compressBound(static_cast<int>(size));
+    auto output = std::make_unique<uint8_t[]>(outputSize);
+
+    auto result = LZ4_compress_HC(reinterpret_cast<const char*>(data),
+                                  reinterpret_cast<char*>(output.get()),
+                                  static_cast<int>(size), outputSize, level);
+    if (result <= 0) {
+        throw Exception("Failed to compress data.");
+    }
+
+    return Stream::makeStream(std::move(output), result);
+}
+
 Stream LZ4Codec::decode(StreamBase& input, uint32_t inputOffset, size_t inputSize, size_t outputSize,
                         bool knownOutputSize)
 {
@@ -48,12 +65,23 @@ Stream LZ4Codec::decode(const uint8_t* data, size_t size, size_t outputSize, boo
     }
 
     auto output = std::make_unique<uint8_t[]>(outputSize);
-    auto result = LZ4_decompress_safe(reinterpret_cast<const char*>(data),
-                                      reinterpret_cast<char*>(output.get()), static_cast<int>(size),
-                                      static_cast<int>(outputSize));
-    if (result != static_cast<int>(outputSize)) {
+
+    auto result = decode(data, size, {output.get(), outputSize});
+    if (result != outputSize) {
         throw Exception("Failed to decompress data.");
     }
 
     return Stream::makeStream(std::move(output), result);
 }
+
+size_t LZ4Codec::decode(const uint8_t* data, size_t size, std::span<uint8_t> output)
+{
+    auto result = LZ4_decompress_safe(reinterpret_cast<const char*>(data),
+                                      reinterpret_cast<char*>(output.data()), static_cast<int>(size),
+                                      static_cast<int>(output.size()));
+    if (result < 0) {
+        throw Exception("Failed to decompress data.");
+    }
+
+    return static_cast<size_t>(result);
+}
@@ -9,8 +9,10 @@ public:
 
     static Stream encode(StreamBase& input, uint32_t inputOffset, size_t inputSize);
     static Stream encode(const uint8_t* data, size_t size);
+    static Stream encodeHC(const uint8_t* data, size_t size, int level);
 
     static Stream decode(StreamBase& input, uint32_t inputOffset, size_t inputSize, size_t outputSize = 0,
                          bool knownOutputSize = false);
     static Stream decode(const uint8_t* data, size_t size, size_t outputSize = 0, bool knownOutputSize = false);
+    static size_t decode(const uint8_t* data, size_t size, std::span<uint8_t> output);
 };
@@ -4,6 +4,38 @@
 
 #include <lz4frame.h>
 
+namespace { // anonymous namespace
+
+// One decompression context per thread, reset after each frame
+class DecompressionContext
+{
+public:
+    DecompressionContext()
+    {
+        if (LZ4F_isError(LZ4F_createDecompressionContext(&m_dctx, LZ4F_VERSION))) {
+            throw Exception("Failed to create decompression context.");
+        }
+    }
+
+    ~DecompressionContext()
+    {
+        LZ4F_freeDecompressionContext(m_dctx);
+    }
+
+    DecompressionContext(const DecompressionContext&) = delete;
+    DecompressionContext& operator=(const DecompressionContext&) = delete;
+
+    LZ4F_dctx* get() const
+    {
+        return m_dctx;
+    }
+
+private:
+    LZ4F_dctx* m_dctx = nullptr;
+};
+
+} // anonymous namespace
+
 Stream LZ4FrameCompressor::decompress(StreamBase& stream, size_t decompressedSize)
 {
     auto [compressed, sz] = Stream::makeStream(stream).detach();
@@ -14,18 +46,23 @@ Stream LZ4FrameCompressor::decompress(const uint8_t* data, size_t size, size_t d
 {
     auto output = std::make_unique<uint8_t[]>(decompressedSize);
 
-    LZ4F_dctx* dctx;
-    if (LZ4F_createDecompressionContext(&dctx, LZ4F_getVersion()) != 0) {
-        throw Exception("Failed to create decompression context.");
-    }
+    auto result = decompress(data, size, {output.get(), decompressedSize});
+
+    return Stream::makeStream(std::move(output), result);
+}
+
+size_t LZ4FrameCompressor::decompress(const uint8_t* data, size_t size, std::span<uint8_t> output)
+{
+    thread_local DecompressionContext context;
 
-    auto result = LZ4F_decompress(dctx, output.get(), &decompressedSize, data, &size, nullptr);
+    auto decompressedSize = output.size();
+    auto result = LZ4F_decompress(context.get(), output.data(), &decompressedSize, data, &size, nullptr);
 
-    LZ4F_freeDecompressionContext(dctx);
+    LZ4F_resetDecompressionContext(context.get());
 
     if (LZ4F_isError(result)) {
         throw Exception(std::format("Failed to decompress data: {}", LZ4F_getErrorName(result)));
     }
 
-    return Stream::makeStream(reinterpret_cast<const char*>(output.get()), decompressedSize);
+    return decompressedSize;
 }
@@ -11,4 +11,5 @@ public:
 
     static Stream decompress(StreamBase& stream, size_t decompressedSize);
     static Stream decompress(const uint8_t* data, size_t size, size_t decompressedSize);
+    static size_t decompress(const uint8_t* data, size_t size, std::span<uint8_t> output);
 };
@@ -113,6 +113,7 @@ void transform(uint32_t buf[4], const uint32_t in[16])
 MD5::MD5()
 {
     m_hMD5 = reinterpret_cast<HMD5>(new MD5Context);
+    init();
 }
 
 MD5::~MD5()
@@ -148,7 +149,20 @@ std::string MD5::digestString(const std::string& str)
     return buf;
 }
 
-void MD5::update(const uint8_t* buf, uint32_t size)
+void MD5::update(const uint8_t* buf, size_t size)
+{
+    // The context counts bytes in 32-bit halves, so feed buffers of any length in pieces
+    constexpr size_t MAX_BLOCK = 1 << 30;
+
+    while (size > 0) {
+        auto block = std::min(size, MAX_BLOCK);
+        updateBlock(buf, static_cast<uint32_t>(block));
+        buf += block;
+        size -= block;
+    }
+}
+
+void MD5::updateBlock(const uint8_t* buf, uint32_t size)
 {
     auto ctx = reinterpret_cast<LPMD5CONTEXT>(m_hMD5);
 
@@ -0,0 +1,108 @@
+#include "pch.h"
+#include "Exception.h"
+#include "MappedFile.h"
+
+MappedFile::MappedFile() :
+    m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_data(nullptr), m_size(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept :
+    m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_data(nullptr), m_size(0)
+{
+    *this = std::move(rhs);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept
+{
+    if (this != &rhs) {
+        close();
+        m_file = rhs.m_file;
+        m_mapping = rhs.m_mapping;
+        m_data = rhs.m_data;
+        m_size = rhs.m_size;
+        rhs.m_file = INVALID_HANDLE_VALUE;
+        rhs.m_mapping = nullptr;
+        rhs.m_data = nullptr;
+        rhs.m_size = 0;
+    }
+
+    return *this;
+}
+
+void MappedFile::open(const char* path)
+{
+    close();
+
+    m_file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        throw Exception(GetLastError());
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size)) {
+        auto error = GetLastError();
+        close();
+        throw Exception(error);
+    }
+
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0) {
+        return; // empty files cannot be mapped
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) {
+        auto error = GetLastError();
+        close();
+        throw Exception(error);
+    }
+
+    m_data = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        auto error = GetLastError();
+        close();
+        throw Exception(error);
+    }
+}
+
+void MappedFile::close()
+{
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+
+    m_size = 0;
+}
+
+bool MappedFile::isOpen() const
+{
+    return m_file != INVALID_HANDLE_VALUE;
+}
+
+const uint8_t* MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
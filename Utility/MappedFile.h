@@ -0,0 +1,28 @@
+#pragma once
+
+// Read-only memory-mapped view of an entire file
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(MappedFile&& rhs) noexcept;
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void open(const char* path);
+    void close();
+
+    bool isOpen() const;
+    const uint8_t* data() const;
+    size_t size() const;
+
+private:
+    HANDLE m_file; // file handle
+    HANDLE m_mapping; // file mapping object
+    const uint8_t* m_data; // base address of the mapped view
+    size_t m_size; // size of the mapped view
+};
@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(uint32_t threads)
+{
+    threads = threadCount(threads);
+
+    m_workers.reserve(threads);
+    for (uint32_t i = 0; i < threads; ++i) {
+        m_workers.emplace_back([this] { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_cv.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+uint32_t ThreadPool::size() const
+{
+    return static_cast<uint32_t>(m_workers.size());
+}
+
+uint32_t ThreadPool::threadCount(uint32_t requested)
+{
+    if (requested != 0) {
+        return requested;
+    }
+
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::run()
+{
+    for (;;) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+
+            if (m_stopping && m_tasks.empty()) {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+// Fixed-size pool of worker threads draining a FIFO task queue
+class ThreadPool
+{
+public:
+    explicit ThreadPool(uint32_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& fn) -> std::future<std::invoke_result_t<F>>;
+
+    uint32_t size() const;
+
+    // Resolves a requested thread count; zero selects the hardware concurrency
+    static uint32_t threadCount(uint32_t requested);
+
+private:
+    void run();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stopping = false;
+};
+
+template <typename F>
+auto ThreadPool::submit(F&& fn) -> std::future<std::invoke_result_t<F>>
+{
+    using R = std::invoke_result_t<F>;
+
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+    auto future = task->get_future();
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_tasks.emplace([task] { (*task)(); });
+    }
+
+    m_cv.notify_one();
+
+    return future;
+}